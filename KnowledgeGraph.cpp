@@ -2,604 +2,5215 @@
 #include "main.h"
 
 // =============================================================================
-// Class Edge Implementation
+// Class SlabPool Implementation
 // =============================================================================
 
-template <class T>
-Edge<T>::Edge(VertexNode<T>* from, VertexNode<T>* to, float weight) {
-    this->from = from;
-    this->to = to;
-    this->weight = weight;
+template <class U>
+SlabPool<U>::SlabPool(size_t slabSize) {
+    this->slabSize = slabSize;
+    this->used = slabSize;
+    this->freeList = nullptr;
 }
 
-template <class T>
-bool Edge<T>::equals(Edge<T> *edge)
+template <class U>
+SlabPool<U>::~SlabPool() {
+    this->release();
+}
+
+template <class U>
+void* SlabPool<U>::allocate()
 {
-    if(!edge) return false;
-    return this->from->equals(edge->from) && this->to->equals(edge->to);
+    if(freeList)
+    {
+        void *slot = freeList;
+        freeList = *static_cast<void**>(slot);
+        return slot;
+    }
+    if(used == slabSize)
+    {
+        slabs.push_back(static_cast<U*>(::operator new(sizeof(U) * slabSize)));
+        used = 0;
+    }
+    return slabs.back() + used++;
 }
 
-template <class T>
-bool Edge<T>::edgeEQ(Edge<T> *&edge1, Edge<T> *&edge2)
+template <class U>
+void SlabPool<U>::recycle(U *obj)
 {
-    if(edge1 == nullptr && edge2 == nullptr) return true;
-    else if(edge1 == nullptr || edge2 == nullptr) return false;
-    return edge1->equals(edge2);
+    *reinterpret_cast<void**>(obj) = freeList;
+    freeList = obj;
 }
 
-template <class T>
-string Edge<T>::toString() {
-    // TODO: Return the string representation of the edge
-    stringstream ss;
-    ss << this->from->toString() << " " << this->to->toString() << " " << weight;
-    return ss.str();
+template <class U>
+size_t SlabPool<U>::bytes()
+{
+    return slabs.size() * slabSize * sizeof(U) + slabs.capacity() * sizeof(U*);
 }
 
-// TODO: Implement other methods of Edge:
+template <class U>
+void SlabPool<U>::swap(SlabPool<U> &other)
+{
+    std::swap(slabs, other.slabs);
+    std::swap(slabSize, other.slabSize);
+    std::swap(used, other.used);
+    std::swap(freeList, other.freeList);
+}
 
+template <class U>
+void SlabPool<U>::release()
+{
+    for(auto slab : slabs)
+        ::operator delete(slab);
+    slabs.clear();
+    used = slabSize;
+    freeList = nullptr;
+}
 
 // =============================================================================
-// Class VertexNode Implementation
+// Class WorkerPool Implementation
 // =============================================================================
 
-template <class T>
-VertexNode<T>::VertexNode(T vertex, bool (*vertexEQ)(T&, T&), string (*vertex2str)(T&)) {
-    this->vertex = vertex;
-    this->vertexEQ = vertexEQ;
-    this->vertex2str = vertex2str;
-    this->inDegree_ = 0;
-    this->outDegree_ = 0;
+WorkerPool::WorkerPool(int threads) {
+    this->generation = 0;
+    this->pending = 0;
+    this->active = 0;
+    this->stopping = false;
+    for(int i = 1; i < threads; i++)
+        workers.emplace_back(&WorkerPool::workerLoop, this, i);
 }
 
-template <class T>
-T &VertexNode<T>::getVertex()
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(auto &worker : workers)
+        worker.join();
+}
+
+int WorkerPool::size()
 {
-    return vertex;
+    return workers.size() + 1;
 }
 
-template <class T>
-void VertexNode<T>::connect(VertexNode<T> *to, float weight)
+void WorkerPool::run(function<void(int)> task, int count)
 {
-    Edge<T> *newedge = new Edge<T>(this, to, weight);
-    this->adList.push_back(newedge);
-    this->outDegree_++;
-    to->inDegree_++;
+    {
+        lock_guard<mutex> guard(lock);
+        this->task = task;
+        active = max(1, min(count, size()));
+        pending = active - 1;
+        generation++;
+    }
+    wake.notify_all();
+    exception_ptr thrown;
+    try
+    {
+        task(0);
+    }
+    catch(...)
+    {
+        thrown = current_exception();
+    }
+    unique_lock<mutex> guard(lock);
+    done.wait(guard, [&] { return pending == 0; });
+    if(!thrown) thrown = failure;
+    failure = nullptr;
+    guard.unlock();
+    if(thrown) rethrow_exception(thrown);
 }
 
-template <class T>
-Edge<T>* VertexNode<T>::getEdge(VertexNode<T> *to)
+void WorkerPool::workerLoop(int worker)
 {
-    for(auto it : adList)
+    unsigned long seen = 0;
+    unique_lock<mutex> guard(lock);
+    while(true)
     {
-        if(it->to->equals(to)) return it;
+        wake.wait(guard, [&] { return stopping || generation != seen; });
+        if(stopping) return;
+        seen = generation;
+        if(worker >= active) continue;
+        function<void(int)> job = task;
+        guard.unlock();
+        exception_ptr thrown;
+        try
+        {
+            job(worker);
+        }
+        catch(...)
+        {
+            thrown = current_exception();
+        }
+        guard.lock();
+        if(thrown && !failure) failure = thrown;
+        if(--pending == 0) done.notify_one();
     }
-    return nullptr;
 }
 
-template <class T>
-bool VertexNode<T>::equals(VertexNode<T> *node)
+// =============================================================================
+// Class EpochDomain Implementation
+// =============================================================================
+
+EpochDomain::SlotBlock::SlotBlock()
 {
-    if(!node) return false;
-    if(vertexEQ)
-        return vertexEQ(this->vertex, node->vertex);
-    return this->vertex == node->vertex;
+    for(auto &slot : slots)
+    {
+        slot.taken.store(false);
+        slot.epoch.store(IDLE);
+    }
+    next.store(nullptr);
 }
 
-template<class T>
-void VertexNode<T>::removeTo(VertexNode<T> *to)
+EpochDomain::EpochDomain()
+{
+    globalEpoch.store(1);
+}
+
+EpochDomain::~EpochDomain()
+{
+    for(auto &item : retired) item.second();
+    SlotBlock *block = head.next.load();
+    while(block)
+    {
+        SlotBlock *next = block->next.load();
+        delete block;
+        block = next;
+    }
+}
+
+int EpochDomain::pin()
 {
-    for(auto it = adList.begin(); it != adList.end(); it++)
+    int start = std::hash<thread::id>()(this_thread::get_id()) % BLOCK_READERS;
+    SlotBlock *block = &head;
+    for(int first = 0; ; first += BLOCK_READERS)
     {
-        Edge<T> *temp_edge = *it;
-        if(temp_edge->to->equals(to))
+        for(int k = 0; k < BLOCK_READERS; k++)
         {
-            this->outDegree_--;
-            temp_edge->to->inDegree_--;
-            delete temp_edge;
-            this->adList.erase(it);
-            return;
+            int i = (start + k) % BLOCK_READERS;
+            ReaderSlot &slot = block->slots[i];
+            bool expected = false;
+            if(slot.taken.load(memory_order_relaxed) || !slot.taken.compare_exchange_strong(expected, true))
+                continue;
+            // The shared pointer must be loaded after this store, see reclaim()
+            slot.epoch.store(globalEpoch.load());
+            return first + i;
+        }
+        SlotBlock *next = block->next.load();
+        if(!next)
+        {
+            // A block linked after reclaim() read the chain only ever sees epochs newer than its tags
+            SlotBlock *created = new SlotBlock();
+            if(block->next.compare_exchange_strong(next, created)) next = created;
+            else delete created;
+        }
+        block = next;
+    }
+}
+
+void EpochDomain::unpin(int slot)
+{
+    SlotBlock *block = &head;
+    for(int k = slot / BLOCK_READERS; k > 0; k--)
+        block = block->next.load();
+    ReaderSlot &reader = block->slots[slot % BLOCK_READERS];
+    reader.epoch.store(IDLE);
+    reader.taken.store(false);
+}
+
+void EpochDomain::retire(function<void()> reclaim)
+{
+    // The caller has already unpublished the object; readers pinned from now on carry a later epoch
+    uint64_t tag = globalEpoch.fetch_add(1);
+    retired.push_back({tag, reclaim});
+    this->reclaim();
+}
+
+void EpochDomain::reclaim()
+{
+    // A reader pinned at epoch e loaded its pointer after reading e, so it can only
+    // hold objects retired with a tag >= e.
+    uint64_t oldest = IDLE;
+    for(SlotBlock *block = &head; block; block = block->next.load())
+    {
+        for(auto &slot : block->slots)
+            oldest = min(oldest, slot.epoch.load());
+    }
+    size_t kept = 0;
+    for(size_t i = 0; i < retired.size(); i++)
+    {
+        if(retired[i].first < oldest) retired[i].second();
+        else retired[kept++] = retired[i];
+    }
+    retired.resize(kept);
+}
+
+size_t EpochDomain::pending()
+{
+    return retired.size();
+}
+
+// =============================================================================
+// Class LatencyHistogram Implementation
+// =============================================================================
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+int LatencyHistogram::bucketOf(uint64_t value)
+{
+    if(value < (uint64_t)SUB_BUCKETS) return value;
+    int shift = 63 - __builtin_clzll(value) - SUB_BITS;
+    return (shift + 1) * SUB_BUCKETS + (int)((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucketValue(int bucket)
+{
+    if(bucket < SUB_BUCKETS) return bucket;
+    int shift = bucket / SUB_BUCKETS - 1;
+    uint64_t mantissa = SUB_BUCKETS + bucket % SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanos)
+{
+    counts[bucketOf(nanos)].fetch_add(1, memory_order_relaxed);
+    total.fetch_add(1, memory_order_relaxed);
+    sum.fetch_add(nanos, memory_order_relaxed);
+    uint64_t seen = minimum.load(memory_order_relaxed);
+    while(nanos < seen && !minimum.compare_exchange_weak(seen, nanos, memory_order_relaxed));
+    seen = maximum.load(memory_order_relaxed);
+    while(nanos > seen && !maximum.compare_exchange_weak(seen, nanos, memory_order_relaxed));
+}
+
+uint64_t LatencyHistogram::count()
+{
+    return total.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::min()
+{
+    return count() ? minimum.load(memory_order_relaxed) : 0;
+}
+
+uint64_t LatencyHistogram::max()
+{
+    return maximum.load(memory_order_relaxed);
+}
+
+double LatencyHistogram::mean()
+{
+    uint64_t n = count();
+    return n ? (double)sum.load(memory_order_relaxed) / n : 0;
+}
+
+uint64_t LatencyHistogram::percentile(double p)
+{
+    uint64_t n = count();
+    if(n == 0) return 0;
+    uint64_t rank = (uint64_t)ceil(p / 100.0 * n);
+    if(rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for(int bucket = 0; bucket < BUCKETS; bucket++)
+    {
+        seen += counts[bucket].load(memory_order_relaxed);
+        // Never report past the largest recorded value
+        if(seen >= rank) return std::min(bucketValue(bucket), max());
+    }
+    return max();
+}
+
+void LatencyHistogram::reset()
+{
+    for(auto &bucket : counts) bucket.store(0, memory_order_relaxed);
+    total.store(0, memory_order_relaxed);
+    sum.store(0, memory_order_relaxed);
+    minimum.store(UINT64_MAX, memory_order_relaxed);
+    maximum.store(0, memory_order_relaxed);
+}
+
+// =============================================================================
+// Class Metrics Implementation
+// =============================================================================
+
+Metrics::Metrics()
+{
+    for(auto &counter : counters) counter.store(0, memory_order_relaxed);
+}
+
+Metrics& Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+bool Metrics::enabled()
+{
+#ifdef KG_ENABLE_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* Metrics::counterName(MetricCounter counter)
+{
+    static const char *names[METRIC_COUNTERS] = {"lookups", "edgesScanned", "verticesVisited", "allocations"};
+    return names[counter];
+}
+
+LatencyHistogram* Metrics::histogram(const char *operation)
+{
+    lock_guard<mutex> guard(registryLock);
+    for(auto &entry : histograms)
+    {
+        if(entry.first == operation) return entry.second;
+    }
+    histograms.push_back({operation, new LatencyHistogram()});
+    return histograms.back().second;
+}
+
+MetricsSnapshot Metrics::snapshot()
+{
+    MetricsSnapshot result;
+    for(int c = 0; c < METRIC_COUNTERS; c++)
+        result.counters[c] = counters[c].load(memory_order_relaxed);
+    lock_guard<mutex> guard(registryLock);
+    for(auto &entry : histograms)
+    {
+        LatencyHistogram *h = entry.second;
+        if(h->count() == 0) continue;
+        result.operations.push_back({entry.first, h->count(), h->mean(), h->min(), h->percentile(50),
+                                     h->percentile(90), h->percentile(99), h->percentile(99.9), h->max()});
+    }
+    return result;
+}
+
+void Metrics::reset()
+{
+    for(auto &counter : counters) counter.store(0, memory_order_relaxed);
+    lock_guard<mutex> guard(registryLock);
+    for(auto &entry : histograms) entry.second->reset();
+}
+
+string Metrics::toText()
+{
+    return snapshot().toText();
+}
+
+string Metrics::toJSON()
+{
+    return snapshot().toJSON();
+}
+
+string MetricsSnapshot::toText()
+{
+    stringstream ss;
+    ss << "counters:\n";
+    for(int c = 0; c < METRIC_COUNTERS; c++)
+        ss << "  " << Metrics::counterName((MetricCounter)c) << " " << counters[c] << "\n";
+    ss << "operations (ns): count mean min p50 p90 p99 p99.9 max\n";
+    for(auto &op : operations)
+    {
+        ss << "  " << op.name << " " << op.count << " " << (uint64_t)op.meanNs << " " << op.minNs << " "
+           << op.p50Ns << " " << op.p90Ns << " " << op.p99Ns << " " << op.p999Ns << " " << op.maxNs << "\n";
+    }
+    return ss.str();
+}
+
+string MetricsSnapshot::toJSON()
+{
+    stringstream ss;
+    ss << "{\"counters\": {";
+    for(int c = 0; c < METRIC_COUNTERS; c++)
+        ss << (c ? ", " : "") << "\"" << Metrics::counterName((MetricCounter)c) << "\": " << counters[c];
+    ss << "}, \"operations\": [";
+    for(size_t i = 0; i < operations.size(); i++)
+    {
+        OperationStats &op = operations[i];
+        ss << (i ? ", " : "") << "{\"name\": \"" << op.name << "\", \"count\": " << op.count
+           << ", \"meanNs\": " << op.meanNs << ", \"minNs\": " << op.minNs << ", \"p50Ns\": " << op.p50Ns
+           << ", \"p90Ns\": " << op.p90Ns << ", \"p99Ns\": " << op.p99Ns << ", \"p999Ns\": " << op.p999Ns
+           << ", \"maxNs\": " << op.maxNs << "}";
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+// =============================================================================
+// Struct MemoryUsage Implementation
+// =============================================================================
+
+template <class V>
+static size_t vectorBytes(const vector<V> &items)
+{
+    return items.capacity() * sizeof(V);
+}
+
+template <class Table>
+static size_t hashTableBytes(const Table &table)
+{
+    // One pointer per bucket, one node (value plus next pointer) per entry
+    return table.bucket_count() * sizeof(void*) + table.size() * (sizeof(typename Table::value_type) + sizeof(void*));
+}
+
+// inList was filled source by source in ascending sourceOf keys, each source's
+// edges in its adList order. Puts it in the order where slot i holds an edge
+// from the source keyed sourceOf(i): sorting the slots by key the same way
+// pairs every edge with its slot.
+template <class T, class Source>
+static void restoreInOrder(vector<Edge<T>*> &inList, Source sourceOf, vector<pair<int,int>> &slots, vector<Edge<T>*> &ordered)
+{
+    slots.resize(inList.size());
+    bool sorted = true;
+    for(size_t i = 0; i < slots.size(); i++)
+    {
+        slots[i] = {sourceOf(i), i};
+        sorted = sorted && (i == 0 || slots[i - 1].first <= slots[i].first);
+    }
+    if(sorted) return;
+    // Ties keep slot order, as a stable sort by key would
+    sort(slots.begin(), slots.end());
+    ordered.resize(inList.size());
+    for(size_t i = 0; i < slots.size(); i++)
+        ordered[slots[i].second] = inList[i];
+    inList.assign(ordered.begin(), ordered.end());
+}
+
+// Payload a value keeps outside itself: only strings past the inline buffer
+static size_t heapBytes(const string &value)
+{
+    return value.capacity() > string().capacity() ? value.capacity() + 1 : 0;
+}
+
+template <class V>
+static size_t heapBytes(const V &)
+{
+    return 0;
+}
+
+size_t MemoryUsage::total()
+{
+    return vertexObjects + edgeObjects + adjacency + adjacencySlack + strings + indexes + derived;
+}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage &other)
+{
+    vertexObjects += other.vertexObjects;
+    edgeObjects += other.edgeObjects;
+    adjacency += other.adjacency;
+    adjacencySlack += other.adjacencySlack;
+    strings += other.strings;
+    indexes += other.indexes;
+    derived += other.derived;
+    return *this;
+}
+
+string MemoryUsage::toText()
+{
+    stringstream ss;
+    ss << "vertexObjects " << vertexObjects << "\n";
+    ss << "edgeObjects " << edgeObjects << "\n";
+    ss << "adjacency " << adjacency << "\n";
+    ss << "adjacencySlack " << adjacencySlack << "\n";
+    ss << "strings " << strings << "\n";
+    ss << "indexes " << indexes << "\n";
+    ss << "derived " << derived << "\n";
+    ss << "total " << total() << "\n";
+    return ss.str();
+}
+
+string MemoryUsage::toJSON()
+{
+    stringstream ss;
+    ss << "{\"vertexObjects\": " << vertexObjects << ", \"edgeObjects\": " << edgeObjects
+       << ", \"adjacency\": " << adjacency << ", \"adjacencySlack\": " << adjacencySlack
+       << ", \"strings\": " << strings << ", \"indexes\": " << indexes
+       << ", \"derived\": " << derived << ", \"total\": " << total() << "}";
+    return ss.str();
+}
+
+// =============================================================================
+// Class ReachabilityIndex Implementation
+// =============================================================================
+
+ReachabilityIndex::ReachabilityIndex() {
+    this->vertexCount = 0;
+    this->valid = false;
+    this->searchEpoch = 0;
+}
+
+bool ReachabilityIndex::isValid()
+{
+    return valid;
+}
+
+void ReachabilityIndex::invalidate()
+{
+    valid = false;
+}
+
+int ReachabilityIndex::components()
+{
+    return level.size();
+}
+
+size_t ReachabilityIndex::bytes()
+{
+    size_t total = vectorBytes(comp) + vectorBytes(dagOffsets) + vectorBytes(dagTargets) + vectorBytes(rdagOffsets)
+                 + vectorBytes(rdagTargets) + vectorBytes(level) + vectorBytes(pre) + vectorBytes(treeEnd)
+                 + vectorBytes(forwardMark) + vectorBytes(backwardMark);
+    for(int pass = 0; pass < LABEL_PASSES; pass++)
+        total += vectorBytes(low[pass]) + vectorBytes(post[pass]);
+    return total;
+}
+
+void ReachabilityIndex::build(int vertices, const vector<int> &offsets, const vector<int> &targets)
+{
+    vertexCount = vertices;
+    condense(offsets, targets);
+    int comps = components();
+    pre.assign(comps, 0);
+    treeEnd.assign(comps, 0);
+    for(int pass = 0; pass < LABEL_PASSES; pass++)
+        label(pass);
+    forwardMark.assign(comps, 0);
+    backwardMark.assign(comps, 0);
+    searchEpoch = 0;
+    valid = true;
+}
+
+void ReachabilityIndex::condense(const vector<int> &offsets, const vector<int> &targets)
+{
+    // Iterative Tarjan
+    int n = vertexCount;
+    vector<int> index(n, -1);
+    vector<int> lowlink(n, 0);
+    vector<int> edgePos(n, 0);
+    vector<char> onStack(n, 0);
+    vector<int> stack;
+    vector<int> callStack;
+    comp.assign(n, -1);
+    int counter = 0;
+    int comps = 0;
+    for(int root = 0; root < n; root++)
+    {
+        if(index[root] != -1) continue;
+        index[root] = lowlink[root] = counter++;
+        edgePos[root] = offsets[root];
+        stack.push_back(root);
+        onStack[root] = 1;
+        callStack.push_back(root);
+        while(!callStack.empty())
+        {
+            int v = callStack.back();
+            if(edgePos[v] < offsets[v + 1])
+            {
+                int w = targets[edgePos[v]++];
+                if(index[w] == -1)
+                {
+                    index[w] = lowlink[w] = counter++;
+                    edgePos[w] = offsets[w];
+                    stack.push_back(w);
+                    onStack[w] = 1;
+                    callStack.push_back(w);
+                }
+                else if(onStack[w]) lowlink[v] = min(lowlink[v], index[w]);
+                continue;
+            }
+            callStack.pop_back();
+            if(!callStack.empty())
+                lowlink[callStack.back()] = min(lowlink[callStack.back()], lowlink[v]);
+            if(lowlink[v] == index[v])
+            {
+                int w;
+                do
+                {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = 0;
+                    comp[w] = comps;
+                } while(w != v);
+                comps++;
+            }
         }
     }
+    // Tarjan emits sink components first; flip ids so every DAG edge goes from a lower to a higher id
+    for(int &c : comp) c = comps - 1 - c;
+
+    // Component DAG without self loops and duplicate edges
+    vector<int> members(n);
+    vector<int> memberOffsets(comps + 1, 0);
+    for(int v = 0; v < n; v++) memberOffsets[comp[v] + 1]++;
+    for(int c = 0; c < comps; c++) memberOffsets[c + 1] += memberOffsets[c];
+    vector<int> fill_pos(memberOffsets.begin(), memberOffsets.end() - 1);
+    for(int v = 0; v < n; v++) members[fill_pos[comp[v]]++] = v;
+
+    vector<int> seen(comps, -1);
+    dagOffsets.assign(comps + 1, 0);
+    dagTargets.clear();
+    for(int c = 0; c < comps; c++)
+    {
+        dagOffsets[c] = dagTargets.size();
+        for(int i = memberOffsets[c]; i < memberOffsets[c + 1]; i++)
+        {
+            int v = members[i];
+            for(int k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                int d = comp[targets[k]];
+                if(d == c || seen[d] == c) continue;
+                seen[d] = c;
+                dagTargets.push_back(d);
+            }
+        }
+    }
+    dagOffsets[comps] = dagTargets.size();
+
+    rdagOffsets.assign(comps + 1, 0);
+    rdagTargets.resize(dagTargets.size());
+    for(int d : dagTargets) rdagOffsets[d + 1]++;
+    for(int c = 0; c < comps; c++) rdagOffsets[c + 1] += rdagOffsets[c];
+    fill_pos.assign(rdagOffsets.begin(), rdagOffsets.end() - 1);
+    for(int c = 0; c < comps; c++)
+    {
+        for(int k = dagOffsets[c]; k < dagOffsets[c + 1]; k++)
+            rdagTargets[fill_pos[dagTargets[k]]++] = c;
+    }
+
+    // Component ids are already a topological order
+    level.assign(comps, 0);
+    for(int c = 0; c < comps; c++)
+    {
+        for(int k = dagOffsets[c]; k < dagOffsets[c + 1]; k++)
+            level[dagTargets[k]] = max(level[dagTargets[k]], level[c] + 1);
+    }
+}
+
+void ReachabilityIndex::label(int pass)
+{
+    // Post-order DFS from every source component. Each pass walks the children in a
+    // different order (forward, reverse, then rotated per component) so that the
+    // intervals rule out different unreachable pairs.
+    int comps = components();
+    vector<int> &lo = low[pass];
+    vector<int> &po = post[pass];
+    lo.assign(comps, INT_MAX);
+    po.assign(comps, -1);
+    vector<char> entered(comps, 0);
+    vector<pair<int,int>> stack; // <component, children already walked>
+    int postCounter = 0;
+    int preCounter = 0;
+
+    for(int i = 0; i < comps; i++)
+    {
+        int root = pass % 2 == 0 ? i : comps - 1 - i;
+        if(entered[root] || rdagOffsets[root] != rdagOffsets[root + 1]) continue;
+        entered[root] = 1;
+        if(pass == 0) pre[root] = preCounter++;
+        stack.push_back({root, 0});
+        while(!stack.empty())
+        {
+            int c = stack.back().first;
+            int walked = stack.back().second;
+            if(walked < dagOffsets[c + 1] - dagOffsets[c])
+            {
+                stack.back().second++;
+                int degree = dagOffsets[c + 1] - dagOffsets[c];
+                int child = walked;
+                if(pass == 1) child = degree - 1 - walked;
+                else if(pass > 1) child = (walked + (unsigned)c * 2654435761u * pass) % degree;
+                int d = dagTargets[dagOffsets[c] + child];
+                if(!entered[d])
+                {
+                    entered[d] = 1;
+                    if(pass == 0) pre[d] = preCounter++;
+                    stack.push_back({d, 0});
+                }
+                else lo[c] = min(lo[c], lo[d]);
+                continue;
+            }
+            po[c] = postCounter++;
+            lo[c] = min(lo[c], po[c]);
+            if(pass == 0) treeEnd[c] = preCounter;
+            stack.pop_back();
+            if(!stack.empty())
+                lo[stack.back().first] = min(lo[stack.back().first], lo[c]);
+        }
+    }
+}
+
+bool ReachabilityIndex::mayReach(int from, int to)
+{
+    if(from == to) return true;
+    if(level[from] >= level[to]) return false;
+    for(int pass = 0; pass < LABEL_PASSES; pass++)
+    {
+        if(low[pass][to] < low[pass][from] || post[pass][to] > post[pass][from]) return false;
+    }
+    return true;
+}
+
+bool ReachabilityIndex::search(int from, int to)
+{
+    searchEpoch++;
+    if(searchEpoch == 0)
+    {
+        fill(forwardMark.begin(), forwardMark.end(), 0);
+        fill(backwardMark.begin(), backwardMark.end(), 0);
+        searchEpoch = 1;
+    }
+    vector<int> forward{from};
+    vector<int> backward{to};
+    vector<int> next;
+    forwardMark[from] = searchEpoch;
+    backwardMark[to] = searchEpoch;
+
+    while(!forward.empty() && !backward.empty())
+    {
+        next.clear();
+        if(forward.size() <= backward.size())
+        {
+            for(int c : forward)
+            {
+                for(int k = dagOffsets[c]; k < dagOffsets[c + 1]; k++)
+                {
+                    int d = dagTargets[k];
+                    if(backwardMark[d] == searchEpoch) return true;
+                    if(forwardMark[d] == searchEpoch || !mayReach(d, to)) continue;
+                    if(pre[d] <= pre[to] && pre[to] < treeEnd[d]) return true;
+                    forwardMark[d] = searchEpoch;
+                    next.push_back(d);
+                }
+            }
+            forward.swap(next);
+        }
+        else
+        {
+            for(int c : backward)
+            {
+                for(int k = rdagOffsets[c]; k < rdagOffsets[c + 1]; k++)
+                {
+                    int d = rdagTargets[k];
+                    if(forwardMark[d] == searchEpoch) return true;
+                    if(backwardMark[d] == searchEpoch || !mayReach(from, d)) continue;
+                    if(pre[from] <= pre[d] && pre[d] < treeEnd[from]) return true;
+                    backwardMark[d] = searchEpoch;
+                    next.push_back(d);
+                }
+            }
+            backward.swap(next);
+        }
+    }
+    return false;
+}
+
+bool ReachabilityIndex::reachable(int from, int to)
+{
+    if(from == to) return true;
+    // Vertices added after the last build have no edges yet: connecting them invalidates the index
+    if(from >= vertexCount || to >= vertexCount) return false;
+    int a = comp[from];
+    int b = comp[to];
+    if(a == b) return true;
+    if(!mayReach(a, b)) return false;
+    if(pre[a] <= pre[b] && pre[b] < treeEnd[a]) return true;
+    return search(a, b);
+}
+
+// =============================================================================
+// Class SymbolTable Implementation
+// =============================================================================
+
+SymbolTable::SymbolTable()
+{
+    deadBytes = 0;
+}
+
+uint64_t SymbolTable::hashName(string_view name)
+{
+    return std::hash<string_view>()(name);
+}
+
+void SymbolTable::rehash(size_t slotCount)
+{
+    // Rebuilt from the old slots, so removed names stay out
+    vector<uint64_t> old(slotCount, 0);
+    old.swap(slots);
+    uint64_t mask = slotCount - 1;
+    for(uint64_t entry : old)
+    {
+        if(!entry) continue;
+        uint64_t hash = hashName(name((uint32_t)(entry & 0xffffffffULL) - 1));
+        uint64_t slot = hash & mask;
+        while(slots[slot]) slot = (slot + 1) & mask;
+        slots[slot] = entry;
+    }
+}
+
+size_t SymbolTable::slotOf(uint32_t id)
+{
+    if(slots.empty()) return 0;
+    uint64_t mask = slots.size() - 1;
+    for(uint64_t slot = hashName(name(id)) & mask; slots[slot]; slot = (slot + 1) & mask)
+    {
+        if((uint32_t)(slots[slot] & 0xffffffffULL) == id + 1) return slot;
+    }
+    return slots.size();
+}
+
+uint32_t SymbolTable::find(string_view name)
+{
+    KG_COUNT(METRIC_LOOKUPS, 1);
+    if(slots.empty()) return npos;
+    uint64_t hash = hashName(name);
+    uint64_t tag = hash >> 32;
+    uint64_t mask = slots.size() - 1;
+    for(uint64_t slot = hash & mask; slots[slot]; slot = (slot + 1) & mask)
+    {
+        if((slots[slot] >> 32) != tag) continue;
+        uint32_t id = (uint32_t)(slots[slot] & 0xffffffffULL) - 1;
+        if(this->name(id) == name) return id;
+    }
+    return npos;
+}
+
+uint32_t SymbolTable::intern(string_view name)
+{
+    uint32_t id = find(name);
+    if(id != npos) return id;
+    id = size();
+    // Keep the table at most half full
+    if(2 * ((size_t)id + 1) > slots.size())
+        rehash(max<size_t>(16, slots.size() * 2));
+    offsets.push_back(arena.size());
+    lengths.push_back(name.size());
+    arena.insert(arena.end(), name.begin(), name.end());
+
+    uint64_t hash = hashName(name);
+    uint64_t mask = slots.size() - 1;
+    uint64_t slot = hash & mask;
+    while(slots[slot]) slot = (slot + 1) & mask;
+    slots[slot] = (hash >> 32) << 32 | (id + 1);
+    return id;
+}
+
+string_view SymbolTable::name(uint32_t id)
+{
+    return string_view(arena.data() + offsets[id], lengths[id]);
+}
+
+uint32_t SymbolTable::size()
+{
+    return offsets.size();
+}
+
+void SymbolTable::reserve(size_t count, size_t bytes)
+{
+    offsets.reserve(count);
+    lengths.reserve(count);
+    if(bytes) arena.reserve(bytes);
+    size_t slotCount = max<size_t>(16, slots.size());
+    while(slotCount < 2 * count) slotCount <<= 1;
+    if(slotCount > slots.size()) rehash(slotCount);
+}
+
+void SymbolTable::clear()
+{
+    arena.clear();
+    offsets.clear();
+    lengths.clear();
+    slots.clear();
+    deadBytes = 0;
+}
+
+size_t SymbolTable::arenaBytes()
+{
+    return vectorBytes(arena);
+}
+
+size_t SymbolTable::indexBytes()
+{
+    return vectorBytes(offsets) + vectorBytes(lengths) + vectorBytes(slots);
+}
+
+void SymbolTable::shrinkToFit()
+{
+    arena.shrink_to_fit();
+    offsets.shrink_to_fit();
+    lengths.shrink_to_fit();
+}
+
+void SymbolTable::remove(uint32_t id)
+{
+    size_t hole = slotOf(id);
+    if(hole >= slots.size()) return;
+    deadBytes += lengths[id];
+    // Backward-shift deletion: pull later entries of the probe run into the hole
+    // unless that would move them in front of their home slot
+    uint64_t mask = slots.size() - 1;
+    for(size_t next = (hole + 1) & mask; slots[next]; next = (next + 1) & mask)
+    {
+        size_t home = hashName(name((uint32_t)(slots[next] & 0xffffffffULL) - 1)) & mask;
+        if(((next - home) & mask) >= ((next - hole) & mask))
+        {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole] = 0;
+}
+
+void SymbolTable::swap(uint32_t a, uint32_t b)
+{
+    size_t slotA = slotOf(a);
+    size_t slotB = slotOf(b);
+    if(slotA < slots.size()) slots[slotA] = (slots[slotA] >> 32) << 32 | (b + 1);
+    if(slotB < slots.size()) slots[slotB] = (slots[slotB] >> 32) << 32 | (a + 1);
+    std::swap(offsets[a], offsets[b]);
+    std::swap(lengths[a], lengths[b]);
+}
+
+void SymbolTable::truncate(uint32_t count)
+{
+    offsets.resize(count);
+    lengths.resize(count);
+    if(2 * deadBytes <= arena.size()) return;
+    // Mostly garbage: repack the surviving names in id order
+    vector<char> packed;
+    packed.reserve(arena.size() - deadBytes);
+    for(uint32_t id = 0; id < count; id++)
+    {
+        uint64_t offset = packed.size();
+        packed.insert(packed.end(), arena.begin() + offsets[id], arena.begin() + offsets[id] + lengths[id]);
+        offsets[id] = offset;
+    }
+    arena.swap(packed);
+    deadBytes = 0;
+}
+
+// =============================================================================
+// Class DaryHeap Implementation
+// =============================================================================
+
+void DaryHeap::push(float key, int id)
+{
+    size_t i = items.size();
+    items.push_back({key, id});
+    while(i > 0)
+    {
+        size_t parent = (i - 1) / ARITY;
+        if(items[parent].first <= key) break;
+        items[i] = items[parent];
+        i = parent;
+    }
+    items[i] = {key, id};
+}
+
+pair<float,int> DaryHeap::pop()
+{
+    pair<float,int> top = items[0];
+    pair<float,int> last = items.back();
+    items.pop_back();
+    size_t n = items.size();
+    if(n == 0) return top;
+    size_t i = 0;
+    while(true)
+    {
+        size_t first = i * ARITY + 1;
+        if(first >= n) break;
+        size_t best = first;
+        size_t end = min(first + ARITY, n);
+        for(size_t c = first + 1; c < end; c++)
+        {
+            if(items[c].first < items[best].first) best = c;
+        }
+        if(items[best].first >= last.first) break;
+        items[i] = items[best];
+        i = best;
+    }
+    items[i] = last;
+    return top;
+}
+
+bool DaryHeap::empty()
+{
+    return items.empty();
+}
+
+void DaryHeap::clear()
+{
+    items.clear();
+}
+
+size_t DaryHeap::bytes()
+{
+    return vectorBytes(items);
+}
+
+// =============================================================================
+// Class Edge Implementation
+// =============================================================================
+
+template <class T>
+Edge<T>::Edge(VertexNode<T>* from, VertexNode<T>* to, float weight, uint32_t label) {
+    this->from = from;
+    this->to = to;
+    this->weight = weight;
+    this->label = label;
+}
+
+template <class T>
+bool Edge<T>::equals(Edge<T> *edge)
+{
+    if(!edge) return false;
+    return this->from->equals(edge->from) && this->to->equals(edge->to);
+}
+
+template <class T>
+bool Edge<T>::edgeEQ(Edge<T> *&edge1, Edge<T> *&edge2)
+{
+    if(edge1 == nullptr && edge2 == nullptr) return true;
+    else if(edge1 == nullptr || edge2 == nullptr) return false;
+    return edge1->equals(edge2);
+}
+
+template <class T>
+string Edge<T>::toString() {
+    // TODO: Return the string representation of the edge
+    stringstream ss;
+    ss << this->from->toString() << " " << this->to->toString() << " " << weight;
+    return ss.str();
+}
+
+// TODO: Implement other methods of Edge:
+
+
+// =============================================================================
+// Class VertexNode Implementation
+// =============================================================================
+
+template <class T>
+VertexNode<T>::VertexNode(T vertex) {
+    this->vertex = vertex;
+    this->id = 0;
+    this->edgePool = nullptr;
+    this->edgeIndex = nullptr;
+    this->partitions = nullptr;
+    this->removed = false;
+    this->inDegree_ = 0;
+    this->outDegree_ = 0;
+}
+
+template <class T>
+VertexNode<T>::~VertexNode()
+{
+    delete edgeIndex;
+    delete partitions;
+}
+
+template <class T>
+T &VertexNode<T>::getVertex()
+{
+    return vertex;
+}
+
+template <class T>
+void VertexNode<T>::buildIndex()
+{
+    edgeIndex = new unordered_multimap<VertexNode<T>*, Edge<T>*>();
+    edgeIndex->reserve(adList.size() * 2);
+    for(auto edge : adList)
+        edgeIndex->emplace(edge->to, edge);
+}
+
+template <class T>
+void VertexNode<T>::partition()
+{
+    partitions = new LabelPartitions();
+    for(auto edge : adList)
+        group(partitions->out, edge);
+    for(auto edge : inList)
+        group(partitions->in, edge);
+}
+
+template <class T>
+void VertexNode<T>::group(LabelGroups &groups, Edge<T> *edge)
+{
+    for(auto &it : groups)
+    {
+        if(it.first == edge->label)
+        {
+            it.second.push_back(edge);
+            return;
+        }
+    }
+    groups.push_back({edge->label, vector<Edge<T>*>(1, edge)});
+}
+
+template <class T>
+void VertexNode<T>::ungroup(LabelGroups &groups, Edge<T> *edge)
+{
+    for(auto it = groups.begin(); it != groups.end(); it++)
+    {
+        if(it->first != edge->label) continue;
+        it->second.erase(find(it->second.begin(), it->second.end(), edge));
+        if(it->second.empty()) groups.erase(it);
+        return;
+    }
+}
+
+template <class T>
+vector<Edge<T>*>* VertexNode<T>::labelled(LabelGroups &groups, uint32_t label)
+{
+    for(auto &it : groups)
+    {
+        if(it.first == label) return &it.second;
+    }
+    return nullptr;
+}
+
+template <class T>
+vector<Edge<T>*>* VertexNode<T>::outEdges(uint32_t label)
+{
+    if(label == ANY_LABEL) return &adList;
+    if(partitions) return labelled(partitions->out, label);
+    if(adList.empty() || adList.front()->label != label) return nullptr;
+    return &adList;
+}
+
+template <class T>
+vector<Edge<T>*>* VertexNode<T>::inEdges(uint32_t label)
+{
+    if(label == ANY_LABEL) return &inList;
+    if(partitions) return labelled(partitions->in, label);
+    if(inList.empty() || inList.front()->label != label) return nullptr;
+    return &inList;
+}
+
+template <class T>
+void VertexNode<T>::connect(VertexNode<T> *to, float weight, uint32_t label)
+{
+    KG_COUNT(METRIC_ALLOCATIONS, 1);
+    Edge<T> *newedge;
+    if(edgePool) newedge = new (edgePool->allocate()) Edge<T>(this, to, weight, label);
+    else newedge = new Edge<T>(this, to, weight, label);
+    // The source side is settled before the target's, so a self-loop is grouped once per direction
+    this->adList.push_back(newedge);
+    if(partitions) group(partitions->out, newedge);
+    else if(adList.front()->label != label) partition();
+    to->inList.push_back(newedge);
+    if(to->partitions) group(to->partitions->in, newedge);
+    else if(to->inList.front()->label != label) to->partition();
+    this->outDegree_++;
+    to->inDegree_++;
+    if(edgeIndex) edgeIndex->emplace(to, newedge);
+    else if((int)adList.size() >= INDEX_DEGREE) buildIndex();
+}
+
+template <class T>
+Edge<T>* VertexNode<T>::getEdge(VertexNode<T> *to, uint32_t label)
+{
+    if(edgeIndex)
+    {
+        Edge<T> *found = nullptr;
+        bool several = false;
+        auto range = edgeIndex->equal_range(to);
+        for(auto it = range.first; it != range.second; it++)
+        {
+            KG_COUNT(METRIC_EDGES_SCANNED, 1);
+            if(label != ANY_LABEL && it->second->label != label) continue;
+            several = found != nullptr;
+            found = it->second;
+        }
+        // The multimap does not keep insertion order among a target's edges
+        if(!several) return found;
+    }
+    for(auto it : adList)
+    {
+        KG_COUNT(METRIC_EDGES_SCANNED, 1);
+        if(it->to->equals(to) && (label == ANY_LABEL || it->label == label)) return it;
+    }
+    return nullptr;
+}
+
+template <class T>
+bool VertexNode<T>::equals(VertexNode<T> *node)
+{
+    // A graph never holds two nodes with equal vertices
+    return this == node;
+}
+
+template <class T>
+void VertexNode<T>::unlink(Edge<T> *edge)
+{
+    // adList keeps insertion order for the traversals, so the erase still
+    // shifts the tail, but finding the slot is a plain pointer compare
+    this->adList.erase(find(adList.begin(), adList.end(), edge));
+    if(edgeIndex)
+    {
+        auto range = edgeIndex->equal_range(edge->to);
+        for(auto it = range.first; it != range.second; it++)
+        {
+            if(it->second != edge) continue;
+            edgeIndex->erase(it);
+            break;
+        }
+        if((int)adList.size() < INDEX_DEGREE / 4)
+        {
+            delete edgeIndex;
+            edgeIndex = nullptr;
+        }
+    }
+    if(partitions) ungroup(partitions->out, edge);
+    this->outDegree_--;
+}
+
+template <class T>
+void VertexNode<T>::unlinkIn(Edge<T> *edge)
+{
+    this->inList.erase(find(inList.begin(), inList.end(), edge));
+    if(partitions) ungroup(partitions->in, edge);
+    this->inDegree_--;
+}
+
+template<class T>
+void VertexNode<T>::removeTo(VertexNode<T> *to, uint32_t label)
+{
+    Edge<T> *temp_edge;
+    while((temp_edge = getEdge(to, label)))
+    {
+        unlink(temp_edge);
+        to->unlinkIn(temp_edge);
+        if(edgePool) edgePool->recycle(temp_edge);
+        else delete temp_edge;
+    }
+}
+
+template <class T>
+int VertexNode<T>::inDegree()
+{
+    return inDegree_;
+}
+
+template <class T>
+int VertexNode<T>::outDegree()
+{
+    return outDegree_;
+}
+
+template <class T>
+string VertexNode<T>::toString()
+{
+    stringstream ss;
+    ss << this->getVertex() << " " << this->inDegree() << " " << this->outDegree();
+    return ss.str();
+}
+// =============================================================================
+// Class FrozenGraph Implementation
+// =============================================================================
+
+template <class T>
+FrozenGraph<T>::FrozenGraph(vector<VertexNode<T>*> &nodeList) : FrozenGraph(nodeList, [](T &vertex) { return vertex; }) {}
+
+template <class T>
+template <class U, class F>
+FrozenGraph<T>::FrozenGraph(vector<VertexNode<U>*> &nodeList, F valueOf)
+{
+    int n = nodeList.size();
+    int m = 0;
+    for(auto node : nodeList) m += node->adList.size();
+
+    values.reserve(n);
+    offsets.resize(n + 1);
+    targets.resize(m);
+    weights.resize(m);
+    labels.resize(m);
+    inOffsets.resize(n + 1);
+    sources.reserve(m);
+
+    int pos = 0;
+    for(int i = 0; i < n; i++)
+    {
+        VertexNode<U> *node = nodeList[i];
+        values.push_back(valueOf(node->vertex));
+        offsets[i] = pos;
+        for(auto edge : node->adList)
+        {
+            targets[pos] = edge->to->id;
+            weights[pos] = edge->weight;
+            labels[pos] = edge->label;
+            pos++;
+        }
+        inOffsets[i] = sources.size();
+        for(auto edge : node->inList)
+            sources.push_back(edge->from->id);
+    }
+    offsets[n] = pos;
+    inOffsets[n] = sources.size();
+}
+
+template <class T>
+int FrozenGraph<T>::size()
+{
+    return values.size();
+}
+
+template <class T>
+int FrozenGraph<T>::edgeCount()
+{
+    return targets.size();
+}
+
+template <class T>
+size_t FrozenGraph<T>::bytes()
+{
+    size_t total = vectorBytes(values) + vectorBytes(offsets) + vectorBytes(targets) + vectorBytes(weights)
+                 + vectorBytes(labels) + vectorBytes(inOffsets) + vectorBytes(sources);
+    for(auto &value : values) total += heapBytes(value);
+    return total;
+}
+
+template <class T>
+T& FrozenGraph<T>::getVertex(int id)
+{
+    return values[id];
+}
+
+template <class T>
+int FrozenGraph<T>::findEdge(int from, int to, uint32_t label)
+{
+    for(int k = offsets[from]; k < offsets[from + 1]; k++)
+    {
+        if(targets[k] == to && (label == ANY_LABEL || labels[k] == label)) return k;
+    }
+    return -1;
+}
+
+// =============================================================================
+// Class GraphVersion Implementation
+// =============================================================================
+
+template <class T>
+template <class U, class F>
+GraphVersion<T>::GraphVersion(vector<VertexNode<U>*> &nodeList, F valueOf, uint64_t number,
+                              function<bool(T&, T&)> vertexEQ, function<string(T&)> vertex2str, function<size_t(T&)> vertexHash,
+                              const SymbolTable &labels)
+    : csr(nodeList, valueOf), labels(labels) {
+    this->number = number;
+    this->vertexEQ = vertexEQ;
+    this->vertex2str = vertex2str;
+    this->vertexHash = vertexHash;
+    if(vertexHash)
+    {
+        index.reserve(csr.size());
+        for(int id = 0; id < csr.size(); id++)
+            index.insert({vertexHash(csr.values[id]), id});
+    }
+}
+
+template <class T>
+size_t GraphVersion<T>::bytes()
+{
+    return csr.bytes() + hashTableBytes(index) + labels.arenaBytes() + labels.indexBytes();
+}
+
+template <class T>
+int GraphVersion<T>::find(T &vertex)
+{
+    auto same = [&](T &value) { return vertexEQ ? vertexEQ(value, vertex) : value == vertex; };
+    if(vertexHash)
+    {
+        auto range = index.equal_range(vertexHash(vertex));
+        for(auto it = range.first; it != range.second; it++)
+        {
+            if(same(csr.values[it->second])) return it->second;
+        }
+        return -1;
+    }
+    for(int id = 0; id < csr.size(); id++)
+    {
+        if(same(csr.values[id])) return id;
+    }
+    return -1;
+}
+
+// =============================================================================
+// Class ReadView Implementation
+// =============================================================================
+
+template <class T>
+ReadView<T>::ReadView(EpochDomain *domain, atomic<GraphVersion<T>*> &published) {
+    this->domain = domain;
+    this->slot = domain->pin();
+    this->version = published.load();
+    this->visitEpoch = 0;
+}
+
+template <class T>
+ReadView<T>::ReadView(ReadView<T> &&other) {
+    this->domain = other.domain;
+    this->slot = other.slot;
+    this->version = other.version;
+    this->visitMark = move(other.visitMark);
+    this->visitEpoch = other.visitEpoch;
+    other.slot = -1;
+}
+
+template <class T>
+ReadView<T>::~ReadView() {
+    if(slot >= 0) domain->unpin(slot);
+}
+
+template <class T>
+int ReadView<T>::find(T &vertex)
+{
+    return version ? version->find(vertex) : -1;
+}
+
+template <class T>
+int ReadView<T>::require(T &vertex)
+{
+    int id = find(vertex);
+    if(id < 0) throw VertexNotFoundException("Vertex not found!");
+    return id;
+}
+
+template <class T>
+void ReadView<T>::beginVisit()
+{
+    int n = size();
+    if((int)visitMark.size() < n) visitMark.resize(n, 0);
+    if(++visitEpoch == 0)
+    {
+        fill(visitMark.begin(), visitMark.end(), 0);
+        visitEpoch = 1;
+    }
+}
+
+template <class T>
+string ReadView<T>::vertex2Str(int id)
+{
+    if(version->vertex2str)
+        return version->vertex2str(version->csr.values[id]);
+    return "";
+}
+
+template <class T>
+uint64_t ReadView<T>::versionNumber()
+{
+    return version ? version->number : 0;
+}
+
+template <class T>
+int ReadView<T>::size()
+{
+    return version ? version->csr.size() : 0;
+}
+
+template <class T>
+int ReadView<T>::edgeCount()
+{
+    return version ? version->csr.edgeCount() : 0;
+}
+
+template <class T>
+bool ReadView<T>::contains(T vertex)
+{
+    return find(vertex) >= 0;
+}
+
+template <class T>
+vector<T> ReadView<T>::vertices()
+{
+    if(!version) return {};
+    return version->csr.values;
+}
+
+template <class T>
+float ReadView<T>::weight(T from, T to)
+{
+    int u = require(from);
+    int v = require(to);
+    int k = version->csr.findEdge(u, v);
+    if(k < 0) throw EdgeNotFoundException("Edge not found!");
+    return version->csr.weights[k];
+}
+
+template <class T>
+bool ReadView<T>::connected(T from, T to)
+{
+    int u = require(from);
+    int v = require(to);
+    return version->csr.findEdge(u, v) >= 0;
+}
+
+template <class T>
+uint32_t ReadView<T>::label(T from, T to)
+{
+    int u = require(from);
+    int v = require(to);
+    int k = version->csr.findEdge(u, v);
+    if(k < 0) throw EdgeNotFoundException("Edge not found!");
+    return version->csr.labels[k];
+}
+
+template <class T>
+bool ReadView<T>::findLabel(string_view name, uint32_t &label)
+{
+    if(name.empty())
+    {
+        label = 0;
+        return true;
+    }
+    if(!version) return false;
+    uint32_t id = version->labels.find(name);
+    if(id == SymbolTable::npos) return false;
+    label = id + 1;
+    return true;
+}
+
+template <class T>
+vector<T> ReadView<T>::getOutwardEdges(T from, uint32_t label)
+{
+    int u = require(from);
+    FrozenGraph<T> &csr = version->csr;
+    vector<T> result;
+    if(label == ANY_LABEL) result.reserve(csr.offsets[u + 1] - csr.offsets[u]);
+    for(int k = csr.offsets[u]; k < csr.offsets[u + 1]; k++)
+    {
+        if(label == ANY_LABEL || csr.labels[k] == label)
+            result.push_back(csr.values[csr.targets[k]]);
+    }
+    return result;
+}
+
+template <class T>
+vector<T> ReadView<T>::getInwardEdges(T to)
+{
+    int v = require(to);
+    FrozenGraph<T> &csr = version->csr;
+    vector<T> result;
+    result.reserve(csr.inOffsets[v + 1] - csr.inOffsets[v]);
+    for(int k = csr.inOffsets[v]; k < csr.inOffsets[v + 1]; k++)
+        result.push_back(csr.values[csr.sources[k]]);
+    return result;
+}
+
+template <class T>
+int ReadView<T>::inDegree(T vertex)
+{
+    int v = require(vertex);
+    return version->csr.inOffsets[v + 1] - version->csr.inOffsets[v];
+}
+
+template <class T>
+int ReadView<T>::outDegree(T vertex)
+{
+    int v = require(vertex);
+    return version->csr.offsets[v + 1] - version->csr.offsets[v];
+}
+
+template <class T>
+string ReadView<T>::BFS(T start, uint32_t label)
+{
+    int s = require(start);
+    FrozenGraph<T> &csr = version->csr;
+    beginVisit();
+    vector<int> queues;
+    visitMark[s] = visitEpoch;
+    queues.push_back(s);
+    string result = "";
+    for(size_t i = 0; i < queues.size(); i++)
+    {
+        int u = queues[i];
+        result += vertex2Str(u) + " ";
+        for(int k = csr.offsets[u]; k < csr.offsets[u + 1]; k++)
+        {
+            int v = csr.targets[k];
+            if(visitMark[v] == visitEpoch || (label != ANY_LABEL && csr.labels[k] != label)) continue;
+            visitMark[v] = visitEpoch;
+            queues.push_back(v);
+        }
+    }
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+template <class T>
+string ReadView<T>::DFS(T start, uint32_t label)
+{
+    int s = require(start);
+    FrozenGraph<T> &csr = version->csr;
+    beginVisit();
+    vector<int> stacks;
+    stacks.push_back(s);
+    string result = "";
+    while(!stacks.empty())
+    {
+        int u = stacks.back();
+        stacks.pop_back();
+        if(visitMark[u] == visitEpoch) continue;
+        visitMark[u] = visitEpoch;
+        result += vertex2Str(u) + " ";
+        for(int k = csr.offsets[u + 1] - 1; k >= csr.offsets[u]; k--)
+        {
+            if(visitMark[csr.targets[k]] != visitEpoch && (label == ANY_LABEL || csr.labels[k] == label))
+                stacks.push_back(csr.targets[k]);
+        }
+    }
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+template <class T>
+vector<T> ReadView<T>::related(T start, int depth, uint32_t label)
+{
+    int s = require(start);
+    FrozenGraph<T> &csr = version->csr;
+    beginVisit();
+    vector<T> result;
+    vector<int> frontier = {s};
+    vector<int> next;
+    visitMark[s] = visitEpoch;
+    for(int level = 0; level < depth && !frontier.empty(); level++)
+    {
+        next.clear();
+        for(int u : frontier)
+        {
+            for(int k = csr.offsets[u]; k < csr.offsets[u + 1]; k++)
+            {
+                int v = csr.targets[k];
+                if(visitMark[v] == visitEpoch || (label != ANY_LABEL && csr.labels[k] != label)) continue;
+                visitMark[v] = visitEpoch;
+                next.push_back(v);
+                result.push_back(csr.values[v]);
+            }
+        }
+        frontier.swap(next);
+    }
+    return result;
+}
+
+// =============================================================================
+// Class CompressedGraph Implementation
+// =============================================================================
+
+template <class T>
+void CompressedGraph<T>::VarintLists::append(vector<int> &sorted)
+{
+    if(offsets.size() % BLOCK == 0) base.push_back(bytes.size());
+    if(bytes.size() - base.back() > UINT32_MAX)
+        throw length_error("CompressedGraph: adjacency block exceeds 4 GiB");
+    offsets.push_back(bytes.size() - base.back());
+    int prev = -1;
+    for(int id : sorted)
+    {
+        putVarint(bytes, id - prev - 1);
+        prev = id;
+    }
+}
+
+template <class T>
+void CompressedGraph<T>::VarintLists::close()
+{
+    // An empty list marks where the last real one ends
+    vector<int> none;
+    append(none);
+    bytes.shrink_to_fit();
+    base.shrink_to_fit();
+    offsets.shrink_to_fit();
+}
+
+template <class T>
+const uint8_t* CompressedGraph<T>::VarintLists::begin(int list)
+{
+    return bytes.data() + base[list / BLOCK] + offsets[list];
+}
+
+template <class T>
+const uint8_t* CompressedGraph<T>::VarintLists::end(int list)
+{
+    return begin(list + 1);
+}
+
+template <class T>
+size_t CompressedGraph<T>::VarintLists::memory()
+{
+    return bytes.capacity() + base.capacity() * sizeof(uint64_t) + offsets.capacity() * sizeof(uint32_t);
+}
+
+template <class T>
+void CompressedGraph<T>::putVarint(vector<uint8_t> &out, uint64_t value)
+{
+    while(value >= 0x80)
+    {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+template <class T>
+uint64_t CompressedGraph<T>::getVarint(const uint8_t *&p)
+{
+    uint64_t value = 0;
+    int shift = 0;
+    uint8_t byte;
+    do
+    {
+        byte = *p++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while(byte & 0x80);
+    return value;
+}
+
+template <class T>
+template <class U, class F>
+CompressedGraph<T>::CompressedGraph(vector<VertexNode<U>*> &nodeList, F valueOf, bool inEdges,
+                                    function<bool(T&, T&)> vertexEQ, function<string(T&)> vertex2str, function<size_t(T&)> vertexHash) {
+    this->inEdges = inEdges;
+    this->edges = 0;
+    this->uniformWeight = 0;
+    this->visitEpoch = 0;
+    this->vertexEQ = vertexEQ;
+    this->vertex2str = vertex2str;
+    this->vertexHash = vertexHash;
+
+    values.reserve(nodeList.size());
+    vector<pair<int, float>> row;
+    vector<int> scratch;
+    for(auto node : nodeList)
+    {
+        values.push_back(valueOf(node->vertex));
+        row.clear();
+        for(auto edge : node->adList)
+            row.push_back({edge->to->id, edge->weight});
+        // Edges under several labels to one target collapse into the first one
+        stable_sort(row.begin(), row.end(), [](const pair<int, float> &a, const pair<int, float> &b) { return a.first < b.first; });
+        row.erase(unique(row.begin(), row.end(), [](const pair<int, float> &a, const pair<int, float> &b) { return a.first == b.first; }), row.end());
+        appendRow(row, scratch);
+        if(inEdges)
+        {
+            scratch.clear();
+            for(auto edge : node->inList)
+                scratch.push_back(edge->from->id);
+            sort(scratch.begin(), scratch.end());
+            scratch.erase(unique(scratch.begin(), scratch.end()), scratch.end());
+            sources.append(scratch);
+        }
+    }
+    finish();
+}
+
+template <class T>
+CompressedGraph<T>::CompressedGraph(vector<T> values, vector<pair<int,int>> &edges, vector<float> *weights, bool inEdges) {
+    this->inEdges = inEdges;
+    this->edges = 0;
+    this->uniformWeight = 0;
+    this->visitEpoch = 0;
+    this->vertexEQ = nullptr;
+    this->vertex2str = VertexFormat<T>();
+    this->vertexHash = [](T &vertex) { return std::hash<T>()(vertex); };
+    this->values = move(values);
+
+    int n = this->values.size();
+    for(auto &edge : edges)
+    {
+        if(edge.first < 0 || edge.first >= n || edge.second < 0 || edge.second >= n)
+            throw VertexNotFoundException("Vertex not found!");
+    }
+    // Counting sort by source; rows keep input order, so the stable sort below
+    // leaves the first copy of a repeated edge in front
+    vector<size_t> start(n + 1, 0);
+    for(auto &edge : edges) start[edge.first + 1]++;
+    for(int v = 0; v < n; v++) start[v + 1] += start[v];
+    vector<pair<int, float>> rows(edges.size());
+    vector<size_t> cursor(start.begin(), start.end() - 1);
+    for(size_t k = 0; k < edges.size(); k++)
+    {
+        float weight = weights && k < weights->size() ? (*weights)[k] : 0;
+        rows[cursor[edges[k].first]++] = {edges[k].second, weight};
+    }
+
+    vector<pair<int, float>> row;
+    vector<int> scratch;
+    auto byTarget = [](const pair<int, float> &a, const pair<int, float> &b) { return a.first < b.first; };
+    auto sameTarget = [](const pair<int, float> &a, const pair<int, float> &b) { return a.first == b.first; };
+    for(int v = 0; v < n; v++)
+    {
+        row.assign(rows.begin() + start[v], rows.begin() + start[v + 1]);
+        stable_sort(row.begin(), row.end(), byTarget);
+        row.erase(unique(row.begin(), row.end(), sameTarget), row.end());
+        appendRow(row, scratch);
+    }
+    vector<pair<int, float>>().swap(rows);
+
+    if(inEdges)
+    {
+        vector<size_t> inStart(n + 1, 0);
+        for(auto &edge : edges) inStart[edge.second + 1]++;
+        for(int v = 0; v < n; v++) inStart[v + 1] += inStart[v];
+        vector<int> from(edges.size());
+        cursor.assign(inStart.begin(), inStart.end() - 1);
+        for(auto &edge : edges) from[cursor[edge.second]++] = edge.first;
+        for(int v = 0; v < n; v++)
+        {
+            scratch.assign(from.begin() + inStart[v], from.begin() + inStart[v + 1]);
+            sort(scratch.begin(), scratch.end());
+            scratch.erase(unique(scratch.begin(), scratch.end()), scratch.end());
+            sources.append(scratch);
+        }
+    }
+    finish();
+}
+
+template <class T>
+void CompressedGraph<T>::appendRow(vector<pair<int, float>> &row, vector<int> &scratch)
+{
+    scratch.clear();
+    for(auto &item : row) scratch.push_back(item.first);
+    targets.append(scratch);
+    edges += row.size();
+
+    weightOffsets.push_back(weightRuns.size());
+    for(size_t k = 0; k < row.size(); )
+    {
+        size_t run = 1;
+        while(k + run < row.size() && row[k + run].second == row[k].second) run++;
+        const uint8_t *bits = reinterpret_cast<const uint8_t*>(&row[k].second);
+        weightRuns.insert(weightRuns.end(), bits, bits + sizeof(float));
+        putVarint(weightRuns, run);
+        k += run;
+    }
+}
+
+template <class T>
+void CompressedGraph<T>::finish()
+{
+    targets.close();
+    if(inEdges) sources.close();
+
+    // One weight for every edge needs no runs at all
+    bool uniform = true;
+    bool seen = false;
+    const uint8_t *p = weightRuns.data();
+    const uint8_t *end = p + weightRuns.size();
+    while(p < end && uniform)
+    {
+        float weight;
+        memcpy(&weight, p, sizeof(float));
+        p += sizeof(float);
+        getVarint(p);
+        if(!seen) uniformWeight = weight;
+        else if(weight != uniformWeight) uniform = false;
+        seen = true;
+    }
+    if(uniform)
+    {
+        vector<uint64_t>().swap(weightOffsets);
+        vector<uint8_t>().swap(weightRuns);
+    }
+    else
+    {
+        weightOffsets.push_back(weightRuns.size());
+        weightOffsets.shrink_to_fit();
+        weightRuns.shrink_to_fit();
+    }
+
+    if(vertexHash)
+    {
+        index.reserve(values.size());
+        for(int id = 0; id < size(); id++)
+            index.insert({vertexHash(values[id]), id});
+    }
+}
+
+template <class T>
+int CompressedGraph<T>::find(T &vertex)
+{
+    auto same = [&](T &value) { return vertexEQ ? vertexEQ(value, vertex) : value == vertex; };
+    if(vertexHash)
+    {
+        auto range = index.equal_range(vertexHash(vertex));
+        for(auto it = range.first; it != range.second; it++)
+        {
+            if(same(values[it->second])) return it->second;
+        }
+        return -1;
+    }
+    for(int id = 0; id < size(); id++)
+    {
+        if(same(values[id])) return id;
+    }
+    return -1;
+}
+
+template <class T>
+int CompressedGraph<T>::require(T &vertex)
+{
+    int id = find(vertex);
+    if(id < 0) throw VertexNotFoundException("Vertex not found!");
+    return id;
+}
+
+template <class T>
+int CompressedGraph<T>::rank(int from, int to)
+{
+    const uint8_t *p = targets.begin(from);
+    const uint8_t *end = targets.end(from);
+    int id = -1;
+    for(int k = 0; p < end; k++)
+    {
+        id += 1 + (int)getVarint(p);
+        if(id == to) return k;
+        if(id > to) break;
+    }
+    return -1;
+}
+
+template <class T>
+float CompressedGraph<T>::weightAt(int from, int k)
+{
+    if(weightOffsets.empty()) return uniformWeight;
+    const uint8_t *p = weightRuns.data() + weightOffsets[from];
+    while(true)
+    {
+        float weight;
+        memcpy(&weight, p, sizeof(float));
+        p += sizeof(float);
+        int run = getVarint(p);
+        if(k < run) return weight;
+        k -= run;
+    }
+}
+
+template <class T>
+void CompressedGraph<T>::beginVisit()
+{
+    if((int)visitMark.size() < size()) visitMark.resize(size(), 0);
+    if(++visitEpoch == 0)
+    {
+        fill(visitMark.begin(), visitMark.end(), 0);
+        visitEpoch = 1;
+    }
+}
+
+template <class T>
+string CompressedGraph<T>::vertex2Str(int id)
+{
+    if(vertex2str) return vertex2str(values[id]);
+    return "";
+}
+
+template <class T>
+int CompressedGraph<T>::size()
+{
+    return values.size();
+}
+
+template <class T>
+int CompressedGraph<T>::edgeCount()
+{
+    return edges;
+}
+
+template <class T>
+size_t CompressedGraph<T>::adjacencyBytes()
+{
+    return targets.memory() + sources.memory() + weightOffsets.capacity() * sizeof(uint64_t) + weightRuns.capacity();
+}
+
+template <class T>
+T CompressedGraph<T>::getVertex(int id)
+{
+    return values[id];
+}
+
+template <class T>
+bool CompressedGraph<T>::contains(T vertex)
+{
+    return find(vertex) >= 0;
+}
+
+template <class T>
+float CompressedGraph<T>::weight(T from, T to)
+{
+    int u = require(from);
+    int v = require(to);
+    int k = rank(u, v);
+    if(k < 0) throw EdgeNotFoundException("Edge not found!");
+    return weightAt(u, k);
+}
+
+template <class T>
+bool CompressedGraph<T>::connected(T from, T to)
+{
+    int u = require(from);
+    int v = require(to);
+    return rank(u, v) >= 0;
+}
+
+template <class T>
+vector<T> CompressedGraph<T>::getOutwardEdges(T from)
+{
+    int u = require(from);
+    vector<T> result;
+    const uint8_t *p = targets.begin(u);
+    const uint8_t *end = targets.end(u);
+    for(int id = -1; p < end; )
+    {
+        id += 1 + (int)getVarint(p);
+        result.push_back(values[id]);
+    }
+    return result;
+}
+
+template <class T>
+vector<T> CompressedGraph<T>::getInwardEdges(T to)
+{
+    int v = require(to);
+    vector<T> result;
+    if(inEdges)
+    {
+        const uint8_t *p = sources.begin(v);
+        const uint8_t *end = sources.end(v);
+        for(int id = -1; p < end; )
+        {
+            id += 1 + (int)getVarint(p);
+            result.push_back(values[id]);
+        }
+        return result;
+    }
+    for(int u = 0; u < size(); u++)
+    {
+        if(rank(u, v) >= 0) result.push_back(values[u]);
+    }
+    return result;
+}
+
+template <class T>
+int CompressedGraph<T>::inDegree(T vertex)
+{
+    int v = require(vertex);
+    int degree = 0;
+    if(inEdges)
+    {
+        // Every varint ends in exactly one byte without the continuation bit
+        for(const uint8_t *p = sources.begin(v); p < sources.end(v); p++)
+            degree += *p < 0x80;
+        return degree;
+    }
+    for(int u = 0; u < size(); u++)
+        degree += rank(u, v) >= 0;
+    return degree;
+}
+
+template <class T>
+int CompressedGraph<T>::outDegree(T vertex)
+{
+    int u = require(vertex);
+    int degree = 0;
+    for(const uint8_t *p = targets.begin(u); p < targets.end(u); p++)
+        degree += *p < 0x80;
+    return degree;
+}
+
+template <class T>
+vector<T> CompressedGraph<T>::vertices()
+{
+    return values;
+}
+
+template <class T>
+string CompressedGraph<T>::BFS(T start)
+{
+    int s = require(start);
+    beginVisit();
+    vector<int> queues{s};
+    visitMark[s] = visitEpoch;
+    string result = "";
+    for(size_t i = 0; i < queues.size(); i++)
+    {
+        int current = queues[i];
+        result += vertex2Str(current) + " ";
+        const uint8_t *p = targets.begin(current);
+        const uint8_t *end = targets.end(current);
+        for(int id = -1; p < end; )
+        {
+            id += 1 + (int)getVarint(p);
+            if(visitMark[id] == visitEpoch) continue;
+            visitMark[id] = visitEpoch;
+            queues.push_back(id);
+        }
+    }
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+template <class T>
+string CompressedGraph<T>::DFS(T start)
+{
+    int s = require(start);
+    beginVisit();
+    vector<int> stacks{s};
+    vector<int> neighbours;
+    string result = "";
+    while(!stacks.empty())
+    {
+        int current = stacks.back();
+        stacks.pop_back();
+        if(visitMark[current] == visitEpoch) continue;
+        visitMark[current] = visitEpoch;
+        result += vertex2Str(current) + " ";
+        neighbours.clear();
+        const uint8_t *p = targets.begin(current);
+        const uint8_t *end = targets.end(current);
+        for(int id = -1; p < end; )
+        {
+            id += 1 + (int)getVarint(p);
+            neighbours.push_back(id);
+        }
+        for(auto it = neighbours.rbegin(); it != neighbours.rend(); it++)
+        {
+            if(visitMark[*it] != visitEpoch)
+                stacks.push_back(*it);
+        }
+    }
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+// =============================================================================
+// Class CommonAncestorEngine Implementation
+// =============================================================================
+
+template <class T>
+CommonAncestorEngine<T>::CommonAncestorEngine(vector<VertexNode<T>*> &nodeList, FrozenGraph<T>* &frozen)
+    : nodeList(nodeList), frozen(frozen) {
+    this->epoch = 0;
+    this->indexedSize = 0;
+    this->indexed = false;
+}
+
+template <class T>
+bool CommonAncestorEngine<T>::hasIndex()
+{
+    return indexed;
+}
+
+template <class T>
+size_t CommonAncestorEngine<T>::bytes()
+{
+    size_t total = vectorBytes(order) + vectorBytes(next) + vectorBytes(parent) + vectorBytes(depth) + vectorBytes(jump);
+    for(int s = 0; s < 2; s++)
+        total += vectorBytes(mark[s]) + vectorBytes(dist[s]) + vectorBytes(onlyCount[s]) + vectorBytes(frontier[s]);
+    return total;
+}
+
+template <class T>
+void CommonAncestorEngine<T>::invalidate()
+{
+    indexed = false;
+}
+
+template <class T>
+int CommonAncestorEngine<T>::nearest(int a, int b, uint32_t label)
+{
+    if(!indexed || label != ANY_LABEL) return search(a, b, label);
+    // Vertices added after the index was built have no parents yet
+    if(a >= indexedSize || b >= indexedSize) return -1;
+    int lca = indexedLCA(a, b);
+    if(lca == -1) return -1;
+    // a and b are not their own ancestors, so step above them
+    if(lca == a || lca == b) return parent[lca];
+    return lca;
+}
+
+template <class T>
+int CommonAncestorEngine<T>::search(int a, int b, uint32_t label)
+{
+    const long long INF = LLONG_MAX / 4;
+    int n = nodeList.size();
+    // The frozen rows carry no labels
+    FrozenGraph<T> *csr = label == ANY_LABEL ? frozen : nullptr;
+    for(int s = 0; s < 2; s++)
+    {
+        if((int)mark[s].size() < n)
+        {
+            mark[s].resize(n, 0);
+            dist[s].resize(n, 0);
+        }
+    }
+    if((int)order.size() < n) order.resize(n, 0);
+    epoch++;
+    if(epoch == 0)
+    {
+        fill(mark[0].begin(), mark[0].end(), 0);
+        fill(mark[1].begin(), mark[1].end(), 0);
+        epoch = 1;
+    }
+
+    int start[2] = {a, b};
+    long long reached[2] = {0, 0};   // every vertex within this distance is known
+    bool exhausted[2] = {false, false};
+    int onlyMin[2] = {1, 1};
+    int discovered = 0;
+    for(int s = 0; s < 2; s++)
+    {
+        mark[s][start[s]] = epoch;
+        dist[s][start[s]] = 0;
+        frontier[s].assign(1, start[s]);
+        onlyCount[s].assign(1, 0);
+    }
+
+    long long bestTotal = INF;
+    int bestOrder = INT_MAX;
+    int best = -1;
+    auto smallestOnly = [&](int s) -> long long {
+        while(onlyMin[s] <= reached[s] && onlyCount[s][onlyMin[s]] == 0) onlyMin[s]++;
+        return onlyMin[s] <= reached[s] ? onlyMin[s] : INF;
+    };
+
+    while(!exhausted[0] || !exhausted[1])
+    {
+        // Lower bound on the total of any candidate not yet seen from side s
+        long long bound = INF;
+        for(int s = 0; s < 2; s++)
+        {
+            int o = 1 - s;
+            if(exhausted[s]) continue;
+            long long other = smallestOnly(o);
+            if(!exhausted[o]) other = min(other, reached[o] + 1);
+            bound = min(bound, reached[s] + 1 + other);
+        }
+        if(bound > bestTotal) break;
+
+        int s = exhausted[0] ? 1 : exhausted[1] ? 0 : (frontier[0].size() <= frontier[1].size() ? 0 : 1);
+        int o = 1 - s;
+        int d = reached[s] + 1;
+        onlyCount[s].push_back(0);
+        next.clear();
+        auto discover = [&](int p) {
+            if(mark[s][p] == epoch) return;
+            mark[s][p] = epoch;
+            dist[s][p] = d;
+            if(s == 0) order[p] = discovered++;
+            next.push_back(p);
+            if(mark[o][p] != epoch)
+            {
+                onlyCount[s][d]++;
+                return;
+            }
+            if(p == start[o]) return;
+            onlyCount[o][dist[o][p]]--;
+            long long total = dist[0][p] + dist[1][p];
+            if(total < bestTotal || (total == bestTotal && order[p] < bestOrder))
+            {
+                bestTotal = total;
+                bestOrder = order[p];
+                best = p;
+            }
+        };
+        for(int v : frontier[s])
+        {
+            if(csr)
+            {
+                for(int k = csr->inOffsets[v]; k < csr->inOffsets[v + 1]; k++)
+                    discover(csr->sources[k]);
+            }
+            else if(auto edges = nodeList[v]->inEdges(label))
+            {
+                for(auto edge : *edges)
+                    discover(edge->from->id);
+            }
+        }
+        frontier[s].swap(next);
+        reached[s] = d;
+        if(frontier[s].empty()) exhausted[s] = true;
+    }
+    return best;
+}
+
+template <class T>
+bool CommonAncestorEngine<T>::buildIndex()
+{
+    int n = nodeList.size();
+    indexed = false;
+    parent.assign(n, -1);
+    depth.assign(n, 0);
+    jump.assign(n, 0);
+    for(auto node : nodeList)
+    {
+        if(node->inList.size() > 1) return false;
+        if(!node->inList.empty()) parent[node->id] = node->inList[0]->from->id;
+    }
+
+    // Top-down from the roots; anything left unvisited sits on a cycle
+    vector<int> queue;
+    for(int v = 0; v < n; v++)
+    {
+        if(parent[v] == -1)
+        {
+            jump[v] = v;
+            queue.push_back(v);
+        }
+    }
+    for(size_t i = 0; i < queue.size(); i++)
+    {
+        int v = queue[i];
+        for(auto edge : nodeList[v]->adList)
+        {
+            int c = edge->to->id;
+            int p = v;
+            depth[c] = depth[p] + 1;
+            // Skew-binary jump pointers: jumps double up while the pattern allows it
+            if(depth[p] - depth[jump[p]] == depth[jump[p]] - depth[jump[jump[p]]])
+                jump[c] = jump[jump[p]];
+            else jump[c] = p;
+            queue.push_back(c);
+        }
+    }
+    if((int)queue.size() != n) return false;
+    indexedSize = n;
+    indexed = true;
+    return true;
+}
+
+template <class T>
+int CommonAncestorEngine<T>::indexedLCA(int a, int b)
+{
+    while(depth[a] > depth[b]) a = depth[jump[a]] >= depth[b] ? jump[a] : parent[a];
+    while(depth[b] > depth[a]) b = depth[jump[b]] >= depth[a] ? jump[b] : parent[b];
+    // Jump targets depend only on depth, so both sides can climb in lock step
+    while(a != b)
+    {
+        if(parent[a] == -1) return -1;
+        if(jump[a] != jump[b])
+        {
+            a = jump[a];
+            b = jump[b];
+        }
+        else
+        {
+            a = parent[a];
+            b = parent[b];
+        }
+    }
+    return a;
+}
+
+// =============================================================================
+// Class GraphSnapshot Implementation
+// =============================================================================
+
+static const char SNAPSHOT_MAGIC[8] = {'K', 'G', 'S', 'N', 'A', 'P', '\0', '\0'};
+static const uint32_t SNAPSHOT_VERSION = 2;
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t len)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    for(size_t i = 0; i < len; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+
+// How each vertex type is stored and hashed inside a snapshot
+template <class T>
+struct SnapshotValue {
+    static uint32_t typeId()
+    {
+        if(is_same<T, int>::value) return 1;
+        if(is_same<T, float>::value) return 2;
+        if(is_same<T, char>::value) return 3;
+        if(is_same<T, uint32_t>::value) return 5;
+        return 0;
+    }
+    static uint64_t hash(T &value)
+    {
+        T normalized = value;
+        if(is_same<T, float>::value && value == 0) normalized = 0;    // -0.0f == 0.0f
+        return fnv1a(FNV_OFFSET, &normalized, sizeof(T));
+    }
+};
+
+template <>
+struct SnapshotValue<string> {
+    static uint32_t typeId() { return 4; }
+    static uint64_t hash(string &value) { return fnv1a(FNV_OFFSET, value.data(), value.size()); }
+};
+
+template <>
+struct SnapshotValue<string_view> {
+    static uint32_t typeId() { return 4; }
+    static uint64_t hash(string_view &value) { return fnv1a(FNV_OFFSET, value.data(), value.size()); }
+};
+
+// Lives here rather than with FrozenGraph so the format code stays in one place
+template <class T>
+template <class V>
+void FrozenGraph<T>::write(string path, vector<V> &values, const vector<string_view> &labelNames)
+{
+    ofstream out(path, ios::binary | ios::trunc);
+    if(!out) throw SnapshotException("Cannot open snapshot: " + path);
+
+    uint64_t n = this->size();
+    uint64_t m = this->edgeCount();
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.valueType = SnapshotValue<V>::typeId();
+    header.vertexCount = n;
+    header.edgeCount = m;
+    header.hashSlots = 1;
+    while(header.hashSlots < 2 * n + 1) header.hashSlots <<= 1;
+    header.labelCount = labelNames.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uint64_t pos = sizeof(header);
+    uint64_t checksum = FNV_OFFSET;
+    auto put = [&](const void *data, size_t len) {
+        out.write(static_cast<const char*>(data), len);
+        checksum = fnv1a(checksum, data, len);
+        pos += len;
+    };
+    auto section = [&](int id) {
+        static const char padding[8] = {0};
+        if(pos % 8) put(padding, 8 - pos % 8);
+        header.section[id] = pos;
+    };
+
+    section(SNAP_VALUES);
+    if constexpr(is_same<V, string>::value || is_same<V, string_view>::value)
+    {
+        vector<uint64_t> stringOffsets(n + 1, 0);
+        for(uint64_t i = 0; i < n; i++)
+            stringOffsets[i + 1] = stringOffsets[i] + values[i].size();
+        put(stringOffsets.data(), stringOffsets.size() * sizeof(uint64_t));
+        section(SNAP_STRINGS);
+        for(auto &value : values)
+            put(value.data(), value.size());
+    }
+    else
+    {
+        put(values.data(), n * sizeof(V));
+        section(SNAP_STRINGS);
+    }
+    section(SNAP_OFFSETS);
+    put(this->offsets.data(), (n + 1) * sizeof(int32_t));
+    section(SNAP_TARGETS);
+    put(this->targets.data(), m * sizeof(int32_t));
+    section(SNAP_WEIGHTS);
+    put(this->weights.data(), m * sizeof(float));
+    section(SNAP_LABELS);
+    put(this->labels.data(), m * sizeof(uint32_t));
+    section(SNAP_IN_OFFSETS);
+    put(this->inOffsets.data(), (n + 1) * sizeof(int32_t));
+    section(SNAP_SOURCES);
+    put(this->sources.data(), m * sizeof(int32_t));
+
+    section(SNAP_HASH);
+    vector<int32_t> table(header.hashSlots, -1);
+    uint64_t mask = header.hashSlots - 1;
+    for(uint64_t id = 0; id < n; id++)
+    {
+        uint64_t slot = SnapshotValue<V>::hash(values[id]) & mask;
+        while(table[slot] >= 0) slot = (slot + 1) & mask;
+        table[slot] = id;
+    }
+    put(table.data(), table.size() * sizeof(int32_t));
+
+    section(SNAP_LABEL_OFFSETS);
+    vector<uint64_t> labelOffsets(labelNames.size() + 1, 0);
+    for(size_t i = 0; i < labelNames.size(); i++)
+        labelOffsets[i + 1] = labelOffsets[i] + labelNames[i].size();
+    put(labelOffsets.data(), labelOffsets.size() * sizeof(uint64_t));
+    section(SNAP_LABEL_STRINGS);
+    for(auto &name : labelNames)
+        put(name.data(), name.size());
+
+    header.fileSize = pos;
+    header.checksum = checksum;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if(!out) throw SnapshotException("Cannot write snapshot: " + path);
+}
+
+template <class T>
+GraphSnapshot<T>::GraphSnapshot(string path, string (*vertex2str)(T&), bool verifyChecksum, bool validateContents) {
+    this->vertex2str = vertex2str;
+    this->visitEpoch = 0;
+    this->mapping = nullptr;
+    this->mappedSize = 0;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) throw SnapshotException("Cannot open snapshot: " + path);
+    struct stat info;
+    if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotHeader))
+    {
+        close(fd);
+        throw SnapshotException("Truncated snapshot: " + path);
+    }
+    mappedSize = info.st_size;
+    mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        throw SnapshotException("Cannot map snapshot: " + path);
+    }
+
+    const char *base = static_cast<const char*>(mapping);
+    header = reinterpret_cast<const SnapshotHeader*>(base);
+    uint64_t n = header->vertexCount;
+    uint64_t m = header->edgeCount;
+    bool isString = is_same<T, string>::value;
+    uint64_t labelCount = header->labelCount;
+    // Every count is bounded by the file size before it is multiplied, and every
+    // end offset is compared by subtraction, so a corrupt header cannot wrap a check.
+    uint64_t countLimit = mappedSize / 4;
+    bool ok = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0 &&
+              header->version == SNAPSHOT_VERSION &&
+              header->valueType == SnapshotValue<T>::typeId() &&
+              header->fileSize == mappedSize && n < INT_MAX && m < INT_MAX && header->hashSlots > n &&
+              labelCount < UINT32_MAX && n <= countLimit && m <= countLimit &&
+              header->hashSlots <= countLimit && labelCount <= countLimit;
+    uint64_t valueBytes = isString ? (n + 1) * sizeof(uint64_t) : n * sizeof(T);
+    uint64_t sectionBytes[SNAPSHOT_SECTIONS] = {
+        valueBytes, 0, (n + 1) * 4, m * 4, m * 4, m * 4, (n + 1) * 4, m * 4, header->hashSlots * 4,
+        (labelCount + 1) * 8, 0
+    };
+    for(int i = 0; ok && i < SNAPSHOT_SECTIONS; i++)
+        ok = header->section[i] % 8 == 0 && header->section[i] <= mappedSize &&
+             sectionBytes[i] <= mappedSize - header->section[i];
+    if(ok && isString)
+    {
+        stringOffsets = reinterpret_cast<const uint64_t*>(base + header->section[SNAP_VALUES]);
+        ok = stringOffsets[n] <= mappedSize - header->section[SNAP_STRINGS];
+    }
+    if(ok)
+    {
+        labelOffsets = reinterpret_cast<const uint64_t*>(base + header->section[SNAP_LABEL_OFFSETS]);
+        ok = labelOffsets[labelCount] <= mappedSize - header->section[SNAP_LABEL_STRINGS];
+        for(uint64_t i = 0; ok && i < labelCount; i++)
+            ok = labelOffsets[i] <= labelOffsets[i + 1];
+    }
+    if(!ok)
+    {
+        munmap(mapping, mappedSize);
+        mapping = nullptr;
+        throw SnapshotException("Invalid snapshot: " + path);
+    }
+
+    stringOffsets = reinterpret_cast<const uint64_t*>(base + header->section[SNAP_VALUES]);
+    podValues = reinterpret_cast<const T*>(base + header->section[SNAP_VALUES]);
+    strings = base + header->section[SNAP_STRINGS];
+    offsets = reinterpret_cast<const int32_t*>(base + header->section[SNAP_OFFSETS]);
+    targets = reinterpret_cast<const int32_t*>(base + header->section[SNAP_TARGETS]);
+    weights = reinterpret_cast<const float*>(base + header->section[SNAP_WEIGHTS]);
+    labels = reinterpret_cast<const uint32_t*>(base + header->section[SNAP_LABELS]);
+    inOffsets = reinterpret_cast<const int32_t*>(base + header->section[SNAP_IN_OFFSETS]);
+    sources = reinterpret_cast<const int32_t*>(base + header->section[SNAP_SOURCES]);
+    hashTable = reinterpret_cast<const int32_t*>(base + header->section[SNAP_HASH]);
+    labelOffsets = reinterpret_cast<const uint64_t*>(base + header->section[SNAP_LABEL_OFFSETS]);
+    labelStrings = base + header->section[SNAP_LABEL_STRINGS];
+
+    if(validateContents && !validate())
+    {
+        munmap(mapping, mappedSize);
+        mapping = nullptr;
+        throw SnapshotException("Invalid snapshot: " + path);
+    }
+    if(verifyChecksum && !verify())
+    {
+        munmap(mapping, mappedSize);
+        mapping = nullptr;
+        throw SnapshotException("Snapshot checksum mismatch: " + path);
+    }
+}
+
+template <class T>
+GraphSnapshot<T>::~GraphSnapshot() {
+    if(mapping) munmap(mapping, mappedSize);
+}
+
+template <class T>
+bool GraphSnapshot<T>::verify()
+{
+    const char *base = static_cast<const char*>(mapping);
+    uint64_t hash = fnv1a(FNV_OFFSET, base + sizeof(SnapshotHeader), mappedSize - sizeof(SnapshotHeader));
+    return hash == header->checksum;
+}
+
+template <class T>
+bool GraphSnapshot<T>::validate()
+{
+    int n = header->vertexCount;
+    int m = header->edgeCount;
+    uint64_t slots = header->hashSlots;
+    if(offsets[0] != 0 || offsets[n] != m || inOffsets[0] != 0 || inOffsets[n] != m || (slots & (slots - 1)) != 0)
+        return false;
+    // In-degrees counted from the targets must match the in-edge rows
+    vector<int> inDegree(n, 0);
+    for(int v = 0; v < n; v++)
+    {
+        if(offsets[v] > offsets[v + 1] || inOffsets[v] > inOffsets[v + 1]) return false;
+    }
+    for(int k = 0; k < m; k++)
+    {
+        if(targets[k] < 0 || targets[k] >= n || sources[k] < 0 || sources[k] >= n) return false;
+        inDegree[targets[k]]++;
+    }
+    for(int v = 0; v < n; v++)
+    {
+        if(inDegree[v] != inOffsets[v + 1] - inOffsets[v]) return false;
+    }
+    if constexpr(is_same<T, string>::value)
+    {
+        if(stringOffsets[0] != 0) return false;
+        for(int v = 0; v < n; v++)
+        {
+            if(stringOffsets[v] > stringOffsets[v + 1]) return false;
+        }
+    }
+    // find() stops at an empty slot, so at most n may be taken
+    uint64_t taken = 0;
+    for(uint64_t slot = 0; slot < slots; slot++)
+    {
+        if(hashTable[slot] >= n || hashTable[slot] < -1) return false;
+        if(hashTable[slot] >= 0) taken++;
+    }
+    return taken <= (uint64_t)n;
+}
+
+template <class T>
+int GraphSnapshot<T>::size()
+{
+    return header->vertexCount;
+}
+
+template <class T>
+int GraphSnapshot<T>::edgeCount()
+{
+    return header->edgeCount;
+}
+
+template <class T>
+bool GraphSnapshot<T>::valueEquals(int id, T &vertex)
+{
+    if constexpr(is_same<T, string>::value)
+    {
+        size_t len = stringOffsets[id + 1] - stringOffsets[id];
+        return len == vertex.size() && memcmp(strings + stringOffsets[id], vertex.data(), len) == 0;
+    }
+    else return podValues[id] == vertex;
+}
+
+template <class T>
+T GraphSnapshot<T>::getVertex(int id)
+{
+    if constexpr(is_same<T, string>::value)
+        return string(strings + stringOffsets[id], stringOffsets[id + 1] - stringOffsets[id]);
+    else return podValues[id];
+}
+
+template <class T>
+int GraphSnapshot<T>::find(T &vertex)
+{
+    uint64_t mask = header->hashSlots - 1;
+    for(uint64_t slot = SnapshotValue<T>::hash(vertex) & mask; ; slot = (slot + 1) & mask)
+    {
+        int id = hashTable[slot];
+        if(id < 0) return -1;
+        if(valueEquals(id, vertex)) return id;
+    }
+}
+
+template <class T>
+string GraphSnapshot<T>::vertex2Str(int id)
+{
+    if(!vertex2str) return "";
+    T value = getVertex(id);
+    return vertex2str(value);
+}
+
+template <class T>
+bool GraphSnapshot<T>::contains(T vertex)
+{
+    return find(vertex) >= 0;
+}
+
+template <class T>
+float GraphSnapshot<T>::weight(T from, T to)
+{
+    int u = find(from);
+    int v = find(to);
+    if(u < 0 || v < 0) throw VertexNotFoundException("Vertex not found!");
+    for(int k = offsets[u]; k < offsets[u + 1]; k++)
+    {
+        if(targets[k] == v) return weights[k];
+    }
+    throw EdgeNotFoundException("Edge not found!");
+}
+
+template <class T>
+uint32_t GraphSnapshot<T>::label(T from, T to)
+{
+    int u = find(from);
+    int v = find(to);
+    if(u < 0 || v < 0) throw VertexNotFoundException("Vertex not found!");
+    for(int k = offsets[u]; k < offsets[u + 1]; k++)
+    {
+        if(targets[k] == v) return labels[k];
+    }
+    throw EdgeNotFoundException("Edge not found!");
+}
+
+template <class T>
+uint32_t GraphSnapshot<T>::labelCount()
+{
+    return header->labelCount;
+}
+
+template <class T>
+string_view GraphSnapshot<T>::labelName(uint32_t label)
+{
+    if(label == 0 || label > header->labelCount) return string_view();
+    return string_view(labelStrings + labelOffsets[label - 1], labelOffsets[label] - labelOffsets[label - 1]);
+}
+
+template <class T>
+bool GraphSnapshot<T>::connected(T from, T to)
+{
+    int u = find(from);
+    int v = find(to);
+    if(u < 0 || v < 0) throw VertexNotFoundException("Vertex not found!");
+    for(int k = offsets[u]; k < offsets[u + 1]; k++)
+    {
+        if(targets[k] == v) return true;
+    }
+    return false;
+}
+
+template <class T>
+vector<T> GraphSnapshot<T>::getOutwardEdges(T from)
+{
+    int u = find(from);
+    if(u < 0) throw VertexNotFoundException("Vertex not found!");
+    vector<T> result;
+    for(int k = offsets[u]; k < offsets[u + 1]; k++)
+        result.push_back(getVertex(targets[k]));
+    return result;
+}
+
+template <class T>
+vector<T> GraphSnapshot<T>::getInwardEdges(T to)
+{
+    int v = find(to);
+    if(v < 0) throw VertexNotFoundException("Vertex not found!");
+    vector<T> result;
+    for(int k = inOffsets[v]; k < inOffsets[v + 1]; k++)
+        result.push_back(getVertex(sources[k]));
+    return result;
+}
+
+template <class T>
+int GraphSnapshot<T>::inDegree(T vertex)
+{
+    int v = find(vertex);
+    if(v < 0) throw VertexNotFoundException("Vertex not found!");
+    return inOffsets[v + 1] - inOffsets[v];
+}
+
+template <class T>
+int GraphSnapshot<T>::outDegree(T vertex)
+{
+    int v = find(vertex);
+    if(v < 0) throw VertexNotFoundException("Vertex not found!");
+    return offsets[v + 1] - offsets[v];
+}
+
+template <class T>
+vector<T> GraphSnapshot<T>::vertices()
+{
+    vector<T> result;
+    result.reserve(size());
+    for(int id = 0; id < size(); id++)
+        result.push_back(getVertex(id));
+    return result;
+}
+
+template <class T>
+string GraphSnapshot<T>::BFS(T start)
+{
+    int s = find(start);
+    if(s < 0) throw VertexNotFoundException("Vertex not found!");
+    if((int)visitMark.size() < size()) visitMark.resize(size(), 0);
+    if(++visitEpoch == 0)
+    {
+        fill(visitMark.begin(), visitMark.end(), 0);
+        visitEpoch = 1;
+    }
+    vector<int> queues{s};
+    visitMark[s] = visitEpoch;
+    string result = "";
+    for(size_t i = 0; i < queues.size(); i++)
+    {
+        int current = queues[i];
+        result += vertex2Str(current) + " ";
+        for(int k = offsets[current]; k < offsets[current + 1]; k++)
+        {
+            if(visitMark[targets[k]] == visitEpoch) continue;
+            visitMark[targets[k]] = visitEpoch;
+            queues.push_back(targets[k]);
+        }
+    }
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+template <class T>
+string GraphSnapshot<T>::DFS(T start)
+{
+    int s = find(start);
+    if(s < 0) throw VertexNotFoundException("Vertex not found!");
+    if((int)visitMark.size() < size()) visitMark.resize(size(), 0);
+    if(++visitEpoch == 0)
+    {
+        fill(visitMark.begin(), visitMark.end(), 0);
+        visitEpoch = 1;
+    }
+    vector<int> stacks{s};
+    string result = "";
+    while(!stacks.empty())
+    {
+        int current = stacks.back();
+        stacks.pop_back();
+        if(visitMark[current] == visitEpoch) continue;
+        visitMark[current] = visitEpoch;
+        result += vertex2Str(current) + " ";
+        for(int k = offsets[current + 1] - 1; k >= offsets[current]; k--)
+        {
+            if(visitMark[targets[k]] != visitEpoch)
+                stacks.push_back(targets[k]);
+        }
+    }
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+// =============================================================================
+// Class DGraphModel Implementation
+// =============================================================================
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::checkequal(T &node1, T &node2)
+{
+    if(vertexEQ) return vertexEQ(node1, node2);
+    return eq(node1, node2);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+DGraphModel<T, Eq, Hash, Fmt>::DGraphModel(bool (*vertexEQ)(T&, T&), string (*vertex2str)(T&), size_t (*vertexHash)(T&), bool pooled) : ancestors(nodeList, frozen) {
+    this->pooled = pooled;
+    this->vertexEQ = vertexEQ;
+    this->vertex2str = vertex2str;
+    this->vertexHash = vertexHash;
+    // A custom equality without a matching hash can only be scanned
+    this->hashed = vertexHash || !vertexEQ;
+    this->visitEpoch = 0;
+    this->frozen = nullptr;
+    this->pool = nullptr;
+    this->published.store(nullptr);
+    this->versions = 0;
+    this->tombstones = 0;
+    this->compactRead = 0;
+    this->compactWrite = 0;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+DGraphModel<T, Eq, Hash, Fmt>::~DGraphModel() {
+    // TODO: Clear all vertices and edges to avoid memory leaks
+    this->clear();
+    delete this->published.load();
+    delete this->pool;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+WorkerPool& DGraphModel<T, Eq, Hash, Fmt>::workerPool(int threads)
+{
+    if(!pool || pool->size() < threads)
+    {
+        delete pool;
+        pool = new WorkerPool(threads);
+    }
+    return *pool;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+VertexNode<T>* DGraphModel<T, Eq, Hash, Fmt>::getVertexNode(T &vertex)
+{
+    KG_COUNT(METRIC_LOOKUPS, 1);
+    if(hashed)
+    {
+        auto range = nodeIndex.equal_range(hashOf(vertex));
+        for(auto it = range.first; it != range.second; it++)
+        {
+            if(checkequal(it->second->vertex, vertex)) return it->second;
+        }
+        return nullptr;
+    }
+    for(auto it : nodeList)
+    {
+        if(!it->removed && checkequal(it->vertex, vertex)) return it;
+    }
+    return nullptr;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+size_t DGraphModel<T, Eq, Hash, Fmt>::hashOf(T &vertex)
+{
+    if(vertexHash) return vertexHash(vertex);
+    return hasher(vertex);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+string DGraphModel<T, Eq, Hash, Fmt>::vertex2Str(VertexNode<T> &node)
+{
+    if(vertex2str)
+        return vertex2str(node.getVertex());
+    return fmt(node.getVertex());
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+string DGraphModel<T, Eq, Hash, Fmt>::edge2Str(Edge<T> &edge)
+{
+    stringstream ss;
+    ss << this->vertex2Str(*edge.from) << "->" << this->vertex2Str(*edge.to);
+    return ss.str();
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::add(T vertex) 
+{
+    KG_TIMED("DGraphModel::add");
+    if(this->getVertexNode(vertex)) return;
+    this->createNode(vertex);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+VertexNode<T>* DGraphModel<T, Eq, Hash, Fmt>::createNode(T &vertex)
+{
+    KG_COUNT(METRIC_ALLOCATIONS, 1);
+    this->thaw();
+    VertexNode<T> *newnode;
+    if(pooled)
+    {
+        newnode = new (nodePool.allocate()) VertexNode<T>(vertex);
+        newnode->edgePool = &edgePool;
+    }
+    else newnode = new VertexNode<T>(vertex);
+    newnode->id = this->nodeList.size();
+    this->nodeList.push_back(newnode);
+    if(hashed)
+        this->nodeIndex.insert({hashOf(newnode->vertex), newnode});
+    return newnode;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::destroyNode(VertexNode<T> *node)
+{
+    if(pooled)
+    {
+        node->~VertexNode<T>();
+        nodePool.recycle(node);
+    }
+    else delete node;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::unindex(VertexNode<T> *node)
+{
+    auto range = nodeIndex.equal_range(hashOf(node->vertex));
+    for(auto it = range.first; it != range.second; it++)
+    {
+        if(it->second == node)
+        {
+            nodeIndex.erase(it);
+            return;
+        }
+    }
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::remove(T vertex)
+{
+    KG_TIMED("DGraphModel::remove");
+    VertexNode<T> *node = getVertexNode(vertex);
+    if(!node) throw VertexNotFoundException("Vertex not found!");
+    this->thaw();
+    this->reach.invalidate();
+    this->ancestors.invalidate();
+
+    // Out-edges first, which also takes a self-loop off node->inList
+    for(auto edge : node->adList)
+    {
+        edge->to->unlinkIn(edge);
+        if(node->edgePool) node->edgePool->recycle(edge);
+        else delete edge;
+    }
+    for(auto edge : node->inList)
+    {
+        edge->from->unlink(edge);
+        if(node->edgePool) node->edgePool->recycle(edge);
+        else delete edge;
+    }
+    node->adList = vector<Edge<T>*>();
+    node->inList = vector<Edge<T>*>();
+    delete node->edgeIndex;
+    node->edgeIndex = nullptr;
+    delete node->partitions;
+    node->partitions = nullptr;
+    node->inDegree_ = 0;
+    node->outDegree_ = 0;
+    node->removed = true;
+    if(hashed) unindex(node);
+    tombstones++;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::compact(int budget)
+{
+    KG_TIMED("DGraphModel::compact");
+    if(tombstones == 0 && compactRead == 0) return true;
+    // Ids move, so everything indexed by id goes
+    this->thaw();
+    this->reach.invalidate();
+    this->ancestors.invalidate();
+    while(true)
+    {
+        // Live nodes slide down in order; the removed ones they pass collect in
+        // [compactWrite, compactRead), so every slot keeps a node whose id is its slot
+        for(; budget > 0 && compactRead < nodeList.size(); budget--, compactRead++)
+        {
+            VertexNode<T> *node = nodeList[compactRead];
+            if(node->removed) continue;
+            if(compactWrite != compactRead)
+            {
+                VertexNode<T> *hole = nodeList[compactWrite];
+                if(renumbered && hashed) unindex(node);
+                nodeList[compactWrite] = node;
+                nodeList[compactRead] = hole;
+                node->id = compactWrite;
+                hole->id = compactRead;
+                if(renumbered)
+                {
+                    renumbered(compactWrite, compactRead);
+                    if(hashed) nodeIndex.insert({hashOf(node->vertex), node});
+                }
+            }
+            compactWrite++;
+        }
+        if(compactRead < nodeList.size()) return false;
+
+        // Pass complete: everything from compactWrite on is a tombstone. Nodes
+        // removed behind the cursors during the pass wait for the next one.
+        for(size_t i = compactWrite; i < nodeList.size(); i++)
+            destroyNode(nodeList[i]);
+        tombstones -= nodeList.size() - compactWrite;
+        nodeList.resize(compactWrite);
+        compactRead = 0;
+        compactWrite = 0;
+        if(tombstones == 0 || budget == 0) return tombstones == 0;
+    }
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<int> DGraphModel<T, Eq, Hash, Fmt>::layoutOrder(VertexLayout layout)
+{
+    int n = nodeList.size();
+    // Total degrees up front, so the sorts below do not visit the nodes
+    vector<size_t> degrees(n);
+    vector<int> seeds;
+    seeds.reserve(n);
+    for(int id = 0; id < n; id++)
+    {
+        degrees[id] = nodeList[id]->adList.size() + nodeList[id]->inList.size();
+        if(!nodeList[id]->removed) seeds.push_back(id);
+    }
+    auto degree = [&](int id) { return degrees[id]; };
+    if(layout == LAYOUT_DEGREE)
+    {
+        stable_sort(seeds.begin(), seeds.end(), [&](int a, int b) { return degree(a) > degree(b); });
+        return seeds;
+    }
+
+    // Cuthill-McKee starts every component at its lowest degree vertex and
+    // queues each vertex's new neighbours by increasing degree
+    bool rcm = layout == LAYOUT_RCM;
+    if(rcm) stable_sort(seeds.begin(), seeds.end(), [&](int a, int b) { return degree(a) < degree(b); });
+    vector<int> order;
+    order.reserve(seeds.size());
+    beginVisit();
+    for(int seed : seeds)
+    {
+        if(!markVisited(seed)) continue;
+        order.push_back(seed);
+        for(size_t i = order.size() - 1; i < order.size(); i++)
+        {
+            VertexNode<T> *node = nodeList[order[i]];
+            size_t first = order.size();
+            for(auto edge : node->adList)
+            {
+                if(markVisited(edge->to->id)) order.push_back(edge->to->id);
+            }
+            if(!rcm) continue;
+            for(auto edge : node->inList)
+            {
+                if(markVisited(edge->from->id)) order.push_back(edge->from->id);
+            }
+            stable_sort(order.begin() + first, order.end(), [&](int a, int b) { return degree(a) < degree(b); });
+        }
+    }
+    if(rcm) reverse(order.begin(), order.end());
+    return order;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::reorder(VertexLayout layout)
+{
+    KG_TIMED("DGraphModel::reorder");
+    vector<int> order = layoutOrder(layout);
+    // Tombstones have no edges; they go last and keep their slots
+    for(size_t id = 0; id < nodeList.size(); id++)
+    {
+        if(nodeList[id]->removed) order.push_back(id);
+    }
+
+    SlabPool<VertexNode<T>> nodes;
+    SlabPool<Edge<T>> edges;
+    vector<VertexNode<T>*> moved(nodeList.size());
+    for(int id : order)
+    {
+        VertexNode<T> *node = nodeList[id];
+        VertexNode<T> *copy;
+        if(pooled) copy = new (nodes.allocate()) VertexNode<T>(std::move(node->vertex));
+        else copy = new VertexNode<T>(std::move(node->vertex));
+        copy->id = node->id;
+        copy->inDegree_ = node->inDegree_;
+        copy->outDegree_ = node->outDegree_;
+        copy->edgePool = node->edgePool;
+        copy->removed = node->removed;
+        moved[id] = copy;
+    }
+    // Each vertex's out-edges end up contiguous, in adList order
+    for(int id : order)
+    {
+        VertexNode<T> *node = nodeList[id];
+        VertexNode<T> *copy = moved[id];
+        copy->adList.reserve(node->adList.size());
+        copy->inList.reserve(node->inList.size());
+        for(auto edge : node->adList)
+        {
+            Edge<T> *fresh;
+            if(pooled) fresh = new (edges.allocate()) Edge<T>(copy, moved[edge->to->id], edge->weight, edge->label);
+            else fresh = new Edge<T>(copy, moved[edge->to->id], edge->weight, edge->label);
+            copy->adList.push_back(fresh);
+        }
+    }
+    // The inLists fill in layout order, ranked so restoreInOrder can match them up
+    vector<int> rank(nodeList.size());
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        rank[order[i]] = i;
+        for(auto fresh : moved[order[i]]->adList)
+            fresh->to->inList.push_back(fresh);
+    }
+    vector<pair<int,int>> slots;
+    vector<Edge<T>*> ordered;
+    for(int id : order)
+    {
+        VertexNode<T> *node = nodeList[id];
+        VertexNode<T> *copy = moved[id];
+        restoreInOrder(copy->inList, [&](int i) { return rank[node->inList[i]->from->id]; }, slots, ordered);
+        if(node->edgeIndex) copy->buildIndex();
+        if(node->partitions) copy->partition();
+    }
+    for(auto &it : nodeIndex)
+        it.second = moved[it.second->id];
+
+    for(size_t id = 0; id < nodeList.size(); id++)
+    {
+        VertexNode<T> *node = nodeList[id];
+        if(pooled) node->~VertexNode<T>();
+        else
+        {
+            for(auto edge : node->adList)
+                delete edge;
+            delete node;
+        }
+        nodeList[id] = moved[id];
+    }
+    if(pooled)
+    {
+        // The old slabs go with the locals
+        nodePool.swap(nodes);
+        edgePool.swap(edges);
+    }
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::reserve(int capacity)
+{
+    this->nodeList.reserve(capacity);
+    if(hashed)
+        this->nodeIndex.reserve(capacity);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::contains(T vertex)
+{
+    KG_TIMED("DGraphModel::contains");
+    return this->getVertexNode(vertex);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+float DGraphModel<T, Eq, Hash, Fmt>::weight(T from, T to, uint32_t label)
+{
+    KG_TIMED("DGraphModel::weight");
+    auto temp_from = getVertexNode(from);
+    auto temp_to = getVertexNode(to);
+    if(!temp_from || !temp_to)
+        throw VertexNotFoundException("Vertex not found!");
+    // The frozen rows are scanned linearly, so hubs answer from their edge index
+    if(frozen && !temp_from->edgeIndex)
+    {
+        int k = frozen->findEdge(temp_from->id, temp_to->id, label);
+        if(k < 0)
+            throw EdgeNotFoundException("Edge not found!");
+        return frozen->weights[k];
+    }
+    auto edge = temp_from->getEdge(temp_to, label);
+    if(!edge)
+        throw EdgeNotFoundException("Edge not found!");
+    return edge->weight;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+uint32_t DGraphModel<T, Eq, Hash, Fmt>::label(T from, T to)
+{
+    KG_TIMED("DGraphModel::label");
+    auto temp_from = getVertexNode(from);
+    auto temp_to = getVertexNode(to);
+    if(!temp_from || !temp_to)
+        throw VertexNotFoundException("Vertex not found!");
+    auto edge = temp_from->getEdge(temp_to);
+    if(!edge)
+        throw EdgeNotFoundException("Edge not found!");
+    return edge->label;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<T> DGraphModel<T, Eq, Hash, Fmt>::getOutwardEdges(T from, uint32_t label)
+{
+    KG_TIMED("DGraphModel::getOutwardEdges");
+    vector<T> result;
+    VertexNode<T> *node = getVertexNode(from);
+    if(!node) throw VertexNotFoundException("Vertex not found!");
+    if(frozen && label == ANY_LABEL)
+    {
+        for(int k = frozen->offsets[node->id]; k < frozen->offsets[node->id + 1]; k++)
+            result.push_back(frozen->values[frozen->targets[k]]);
+        return result;
+    }
+    auto edges = node->outEdges(label);
+    if(!edges) return result;
+    for(auto it : *edges)
+    {
+        result.push_back(it->to->getVertex());
+    }
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<T> DGraphModel<T, Eq, Hash, Fmt>::getInwardEdges(T to, uint32_t label)
+{
+    KG_TIMED("DGraphModel::getInwardEdges");
+    vector<T> result;
+    VertexNode<T> *node = getVertexNode(to);
+    if(!node) throw VertexNotFoundException("Vertex not found!");
+    auto edges = node->inEdges(label);
+    if(!edges) return result;
+    for(auto it : *edges)
+    {
+        result.push_back(it->from->getVertex());
+    }
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::connect(T from, T to, float weight, uint32_t label) 
+{
+    KG_TIMED("DGraphModel::connect");
+    auto temp_from = getVertexNode(from);
+    auto temp_to = getVertexNode(to);
+    if(!temp_from)
+        throw VertexNotFoundException("Vertex not found!");
+    if(!temp_to)
+        throw VertexNotFoundException("Vertex not found!");
+    if(temp_from->getEdge(temp_to, label)) return;
+
+    this->thaw();
+    // An edge inside the existing transitive closure leaves the reachability index valid
+    if(reach.isValid() && !reach.reachable(temp_from->id, temp_to->id))
+        reach.invalidate();
+    ancestors.invalidate();
+    temp_from->connect(temp_to, weight, label);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::disconnect(T from, T to, uint32_t label)
+{
+    KG_TIMED("DGraphModel::disconnect");
+    auto temp_from = getVertexNode(from);
+    auto temp_to = getVertexNode(to);
+    if(!temp_from)
+        throw VertexNotFoundException("Vertex not found!");
+    if(!temp_to)
+        throw VertexNotFoundException("Vertex not found!");
+    if(temp_from->getEdge(temp_to, label))
+    {
+        this->thaw();
+        this->reach.invalidate();
+        this->ancestors.invalidate();
+        temp_from->removeTo(temp_to, label);
+    }
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::connected(T from, T to, uint32_t label)
+{
+    KG_TIMED("DGraphModel::connected");
+    auto temp_from = getVertexNode(from);
+    auto temp_to = getVertexNode(to);
+    if(!temp_from)
+        throw VertexNotFoundException("Vertex not found!");
+    if(!temp_to)
+        throw VertexNotFoundException("Vertex not found!");
+    if(frozen && !temp_from->edgeIndex) return frozen->findEdge(temp_from->id, temp_to->id, label) >= 0;
+    return temp_from->getEdge(temp_to, label);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+int DGraphModel<T, Eq, Hash, Fmt>::size()
+{
+    return nodeList.size() - tombstones;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::empty()
+{
+    return this->size() == 0;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::clear()
+{
+    KG_TIMED("DGraphModel::clear");
+    this->thaw();
+    this->reach.invalidate();
+    this->ancestors.invalidate();
+    if(pooled)
+    {
+        // Edges are trivially destructible, so whole slabs can go at once
+        for(auto node : nodeList)
+            node->~VertexNode<T>();
+        edgePool.release();
+        nodePool.release();
+    }
+    else
+    {
+        for(auto node : nodeList)
+        {
+            for(auto edge : node->adList)
+            {
+                delete edge;
+            }
+            node->adList.clear();
+            node->inList.clear();
+            delete node;
+        }
+    }
+    this->nodeList.clear();
+    this->nodeIndex.clear();
+    this->visitMark.clear();
+    this->traversalBuf.clear();
+    this->visitEpoch = 0;
+    this->tombstones = 0;
+    this->compactRead = 0;
+    this->compactWrite = 0;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+int DGraphModel<T, Eq, Hash, Fmt>::inDegree(T vertex)
+{
+    KG_TIMED("DGraphModel::inDegree");
+    auto node = getVertexNode(vertex);
+    if(!node) throw VertexNotFoundException("Vertex not found!");
+    return node->inDegree_;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+int DGraphModel<T, Eq, Hash, Fmt>::outDegree(T vertex)
+{
+    KG_TIMED("DGraphModel::outDegree");
+    auto node = getVertexNode(vertex);
+    if(!node) throw VertexNotFoundException("Vertex not found!");
+    return node->outDegree_;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<T> DGraphModel<T, Eq, Hash, Fmt>::vertices()
+{
+    KG_TIMED("DGraphModel::vertices");
+    vector<T> result;
+    for(auto node : nodeList)
+    {
+        if(!node->removed) result.push_back(node->getVertex());
+    }
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+string DGraphModel<T, Eq, Hash, Fmt>::toString() {
+    KG_TIMED("DGraphModel::toString");
+    string result = "";
+    for (VertexNode<T>* node : this->nodeList) {
+        if (node->removed) continue;
+        string nodeStr = this->vertex2Str(*node); 
+        result += "Vertex: " + nodeStr + "\n";
+        if (!node->adList.empty()) {
+            result += "  Edges:\n";
+            for (Edge<T>* edge : node->adList) {
+                // Sử dụng hàm edge2Str của DGraphModel để lấy chuỗi biểu diễn cạnh
+                result += "    -> " + this->edge2Str(*edge) + "\n"; 
+            }
+        }
+    }
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::beginVisit()
+{
+    if(visitMark.size() < nodeList.size())
+        visitMark.resize(nodeList.size(), 0);
+    visitEpoch++;
+    if(visitEpoch == 0)
+    {
+        // Epoch counter wrapped around: stale marks could now look current
+        fill(visitMark.begin(), visitMark.end(), 0);
+        visitEpoch = 1;
+    }
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::markVisited(VertexNode<T> *node)
+{
+    if(visitMark[node->id] == visitEpoch) return false;
+    visitMark[node->id] = visitEpoch;
+    return true;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::isVisited(VertexNode<T> *node)
+{
+    return visitMark[node->id] == visitEpoch;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::markVisited(int id)
+{
+    if(visitMark[id] == visitEpoch) return false;
+    visitMark[id] = visitEpoch;
+    return true;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::reachable(T from, T to)
+{
+    KG_TIMED("DGraphModel::reachable");
+    auto temp_from = getVertexNode(from);
+    auto temp_to = getVertexNode(to);
+    if(!temp_from || !temp_to)
+        throw VertexNotFoundException("Vertex not found!");
+    if(!reach.isValid())
+    {
+        if(frozen) reach.build(frozen->size(), frozen->offsets, frozen->targets);
+        else
+        {
+            vector<int> offsets(nodeList.size() + 1, 0);
+            vector<int> targets;
+            for(size_t i = 0; i < nodeList.size(); i++)
+            {
+                offsets[i] = targets.size();
+                for(auto edge : nodeList[i]->adList)
+                    targets.push_back(edge->to->id);
+            }
+            offsets[nodeList.size()] = targets.size();
+            reach.build(nodeList.size(), offsets, targets);
+        }
+    }
+    return reach.reachable(temp_from->id, temp_to->id);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::nearestCommonAncestor(T a, T b, T &result, uint32_t label)
+{
+    KG_TIMED("DGraphModel::nearestCommonAncestor");
+    auto node_a = getVertexNode(a);
+    auto node_b = getVertexNode(b);
+    if(!node_a || !node_b)
+        throw VertexNotFoundException("Vertex not found!");
+    int id = ancestors.nearest(node_a->id, node_b->id, label);
+    if(id < 0) return false;
+    result = nodeList[id]->vertex;
+    return true;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::buildAncestorIndex()
+{
+    KG_TIMED("DGraphModel::buildAncestorIndex");
+    return ancestors.buildIndex();
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::freeze()
+{
+    KG_TIMED("DGraphModel::freeze");
+    if(frozen) return;
+    frozen = new FrozenGraph<T>(nodeList);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::thaw()
+{
+    delete frozen;
+    frozen = nullptr;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::copyPolicies(function<bool(T&, T&)> &equal, function<string(T&)> &format, function<size_t(T&)> &hash)
+{
+    Eq eq = this->eq;
+    Hash hasher = this->hasher;
+    Fmt fmt = this->fmt;
+    auto vertexEQ = this->vertexEQ;
+    auto vertex2str = this->vertex2str;
+    auto vertexHash = this->vertexHash;
+    equal = [eq, vertexEQ](T &a, T &b) { return vertexEQ ? vertexEQ(a, b) : eq(a, b); };
+    format = [fmt, vertex2str](T &vertex) { return vertex2str ? vertex2str(vertex) : fmt(vertex); };
+    hash = nullptr;
+    if(hashed) hash = [hasher, vertexHash](T &vertex) { return vertexHash ? vertexHash(vertex) : hasher(vertex); };
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+uint64_t DGraphModel<T, Eq, Hash, Fmt>::publish()
+{
+    KG_TIMED("DGraphModel::publish");
+    compact();
+    // The version keeps copies of the policies, so readers never touch this
+    // graph's members; ~DGraphModel still frees it, so views must not outlive the graph
+    function<bool(T&, T&)> equal;
+    function<string(T&)> format;
+    function<size_t(T&)> hash;
+    copyPolicies(equal, format, hash);
+    auto version = new GraphVersion<T>(nodeList, [](T &vertex) { return vertex; }, ++versions, equal, format, hash);
+    GraphVersion<T> *old = published.exchange(version);
+    if(old) epochs.retire([old]() { delete old; });
+    return versions;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+ReadView<T> DGraphModel<T, Eq, Hash, Fmt>::read()
+{
+    return ReadView<T>(&epochs, published);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+CompressedGraph<T> DGraphModel<T, Eq, Hash, Fmt>::compress(bool inEdges)
+{
+    KG_TIMED("DGraphModel::compress");
+    compact();
+    function<bool(T&, T&)> equal;
+    function<string(T&)> format;
+    function<size_t(T&)> hash;
+    copyPolicies(equal, format, hash);
+    return CompressedGraph<T>(nodeList, [](T &vertex) { return vertex; }, inEdges, equal, format, hash);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+MemoryUsage DGraphModel<T, Eq, Hash, Fmt>::memoryUsage()
+{
+    KG_TIMED("DGraphModel::memoryUsage");
+    MemoryUsage usage = {};
+    size_t edges = 0;
+    for(auto node : nodeList)
+    {
+        edges += node->adList.size();
+        usage.adjacency += (node->adList.size() + node->inList.size()) * sizeof(Edge<T>*);
+        usage.adjacencySlack += (node->adList.capacity() - node->adList.size() + node->inList.capacity() - node->inList.size()) * sizeof(Edge<T>*);
+        usage.strings += heapBytes(node->vertex);
+        if(node->edgeIndex) usage.indexes += sizeof(*node->edgeIndex) + hashTableBytes(*node->edgeIndex);
+        if(node->partitions)
+        {
+            usage.indexes += sizeof(*node->partitions) + vectorBytes(node->partitions->out) + vectorBytes(node->partitions->in);
+            for(auto &it : node->partitions->out)
+                usage.indexes += vectorBytes(it.second);
+            for(auto &it : node->partitions->in)
+                usage.indexes += vectorBytes(it.second);
+        }
+    }
+    usage.vertexObjects = (pooled ? nodePool.bytes() : nodeList.size() * sizeof(VertexNode<T>)) + nodeList.size() * sizeof(VertexNode<T>*);
+    usage.adjacencySlack += (nodeList.capacity() - nodeList.size()) * sizeof(VertexNode<T>*);
+    usage.edgeObjects = pooled ? edgePool.bytes() : edges * sizeof(Edge<T>);
+    usage.indexes += hashTableBytes(nodeIndex);
+    usage.derived = reach.bytes() + ancestors.bytes() + pathHeap.bytes() + vectorBytes(visitMark) + vectorBytes(traversalBuf)
+                  + vectorBytes(pathDist) + vectorBytes(pathParent);
+    if(frozen) usage.derived += frozen->bytes();
+    GraphVersion<T> *version = published.load();
+    if(version) usage.derived += version->bytes();
+    return usage;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::shrinkToFit()
+{
+    KG_TIMED("DGraphModel::shrinkToFit");
+    nodeList.shrink_to_fit();
+    for(auto node : nodeList)
+    {
+        node->adList.shrink_to_fit();
+        node->inList.shrink_to_fit();
+        if(node->partitions)
+        {
+            for(auto &it : node->partitions->out)
+                it.second.shrink_to_fit();
+            for(auto &it : node->partitions->in)
+                it.second.shrink_to_fit();
+        }
+    }
+    if(hashed) nodeIndex.rehash(0);
+    traversalBuf = vector<TraversalItem>();
+    pathDist = vector<float>();
+    pathParent = vector<int>();
+    pathHeap = DaryHeap();
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+bool DGraphModel<T, Eq, Hash, Fmt>::isFrozen()
+{
+    return frozen != nullptr;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::traverseBFS(T start, Visitor visit, uint32_t label)
+{
+    KG_TIMED("DGraphModel::traverseBFS");
+    auto startnode = getVertexNode(start);
+    if(!startnode) throw VertexNotFoundException("Vertex not found!");
+    beginVisit();
+    vector<TraversalItem> &queues = traversalBuf;
+    queues.clear();
+    markVisited(startnode->id);
+    queues.push_back({startnode->id, -1, 0});
+
+    for(size_t currentidx = 0; currentidx < queues.size(); currentidx++)
+    {
+        TraversalItem current = queues[currentidx];
+        VertexNode<T> *parent = current.parent < 0 ? nullptr : nodeList[current.parent];
+        if(!visit(*nodeList[current.id], current.depth, parent)) break;
+        KG_COUNT(METRIC_VERTICES_VISITED, 1);
+
+        if(frozen && label == ANY_LABEL)
+        {
+            KG_COUNT(METRIC_EDGES_SCANNED, frozen->offsets[current.id + 1] - frozen->offsets[current.id]);
+            for(int k = frozen->offsets[current.id]; k < frozen->offsets[current.id + 1]; k++)
+            {
+                if(markVisited(frozen->targets[k]))
+                    queues.push_back({frozen->targets[k], current.id, current.depth + 1});
+            }
+            continue;
+        }
+        auto edges = nodeList[current.id]->outEdges(label);
+        if(!edges) continue;
+        KG_COUNT(METRIC_EDGES_SCANNED, edges->size());
+        for(auto edge : *edges)
+        {
+            if(markVisited(edge->to->id))
+                queues.push_back({edge->to->id, current.id, current.depth + 1});
+        }
+    }
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::traverseDFS(T start, Visitor visit, uint32_t label)
+{
+    KG_TIMED("DGraphModel::traverseDFS");
+    auto startnode = getVertexNode(start);
+    if(!startnode) throw VertexNotFoundException("Vertex not found!");
+    beginVisit();
+    vector<TraversalItem> &stacks = traversalBuf;
+    stacks.clear();
+    stacks.push_back({startnode->id, -1, 0});
+
+    while(!stacks.empty())
+    {
+        TraversalItem current = stacks.back();
+        stacks.pop_back();
+
+        if(!markVisited(current.id)) continue;
+        VertexNode<T> *parent = current.parent < 0 ? nullptr : nodeList[current.parent];
+        if(!visit(*nodeList[current.id], current.depth, parent)) break;
+        KG_COUNT(METRIC_VERTICES_VISITED, 1);
+
+        if(frozen && label == ANY_LABEL)
+        {
+            KG_COUNT(METRIC_EDGES_SCANNED, frozen->offsets[current.id + 1] - frozen->offsets[current.id]);
+            for(int k = frozen->offsets[current.id + 1] - 1; k >= frozen->offsets[current.id]; k--)
+            {
+                if(visitMark[frozen->targets[k]] != visitEpoch)
+                    stacks.push_back({frozen->targets[k], current.id, current.depth + 1});
+            }
+            continue;
+        }
+        auto edges = nodeList[current.id]->outEdges(label);
+        if(!edges) continue;
+        auto &adList = *edges;
+        KG_COUNT(METRIC_EDGES_SCANNED, adList.size());
+        for(auto it = adList.rbegin(); it != adList.rend(); it++)
+        {
+            auto neighbor = (*it)->to;
+            if(visitMark[neighbor->id] != visitEpoch)
+                stacks.push_back({neighbor->id, current.id, current.depth + 1});
+        }
+    }
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+string DGraphModel<T, Eq, Hash, Fmt>::BFS(T start)
+{
+    KG_TIMED("DGraphModel::BFS");
+    string result = "";
+    traverseBFS(start, [&](VertexNode<T> &node, int, VertexNode<T>*) {
+        result += this->vertex2Str(node) + " ";
+        return true;
+    });
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+string DGraphModel<T, Eq, Hash, Fmt>::DFS(T start)
+{
+    KG_TIMED("DGraphModel::DFS");
+    string result = "";
+    traverseDFS(start, [&](VertexNode<T> &node, int, VertexNode<T>*) {
+        result += this->vertex2Str(node) + " ";
+        return true;
+    });
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<vector<int>> DGraphModel<T, Eq, Hash, Fmt>::levelIds(int start, int threads, int maxDepth)
+{
+    // Like the serial walks, a negative limit stops before the start vertex
+    if(maxDepth < 0) return vector<vector<int>>();
+    if(threads > 1) return parallelLevelIds(start, threads, maxDepth);
+    vector<vector<int>> levels;
+    traverseBFS(nodeList[start]->vertex, [&](VertexNode<T> &node, int depth, VertexNode<T>*) {
+        if(depth > maxDepth) return false;
+        if(depth == (int)levels.size()) levels.push_back({});
+        levels[depth].push_back(node.id);
+        return true;
+    });
+    for(auto &level : levels)
+        sort(level.begin(), level.end());
+    return levels;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<vector<int>> DGraphModel<T, Eq, Hash, Fmt>::parallelLevelIds(int start, int threads, int maxDepth)
+{
+    freeze();
+    FrozenGraph<T> &csr = *frozen;
+    int n = csr.size();
+    WorkerPool &pool = workerPool(threads);
+    int workers = threads;
+
+    unique_ptr<atomic<int>[]> depthOf(new atomic<int>[n]);
+    pool.run([&](int w) {
+        for(int v = (long)n * w / workers; v < (long)n * (w + 1) / workers; v++)
+            depthOf[v].store(-1, memory_order_relaxed);
+    }, workers);
+    depthOf[start].store(0, memory_order_relaxed);
+
+    vector<vector<int>> levels;
+    levels.push_back({start});
+    vector<vector<int>> localNext(workers);
+    long edgesToCheck = csr.edgeCount();
+    bool bottomUp = false;
+    int depth = 0;
+
+    while(depth < maxDepth)
+    {
+        vector<int> &frontier = levels.back();
+        long frontierEdges = 0;
+        for(int u : frontier)
+            frontierEdges += csr.offsets[u + 1] - csr.offsets[u];
+        edgesToCheck -= frontierEdges;
+        KG_COUNT(METRIC_VERTICES_VISITED, frontier.size());
+
+        // Direction-optimizing switch: scanning in-edges of the unvisited vertices pays off
+        // once the frontier's out-edges outweigh them, until the frontier shrinks again.
+        if(!bottomUp && frontierEdges > edgesToCheck / 14) bottomUp = true;
+        else if(bottomUp && (long)frontier.size() < n / 24) bottomUp = false;
+        if(!bottomUp) KG_COUNT(METRIC_EDGES_SCANNED, frontierEdges);
+
+        pool.run([&](int w) {
+            vector<int> &next = localNext[w];
+            next.clear();
+            if(bottomUp)
+            {
+                for(int v = (long)n * w / workers; v < (long)n * (w + 1) / workers; v++)
+                {
+                    if(depthOf[v].load(memory_order_relaxed) != -1) continue;
+                    for(int k = csr.inOffsets[v]; k < csr.inOffsets[v + 1]; k++)
+                    {
+                        if(depthOf[csr.sources[k]].load(memory_order_relaxed) == depth)
+                        {
+                            depthOf[v].store(depth + 1, memory_order_relaxed);
+                            next.push_back(v);
+                            break;
+                        }
+                    }
+                }
+                return;
+            }
+            size_t lo = frontier.size() * w / workers;
+            size_t hi = frontier.size() * (w + 1) / workers;
+            for(size_t i = lo; i < hi; i++)
+            {
+                int u = frontier[i];
+                for(int k = csr.offsets[u]; k < csr.offsets[u + 1]; k++)
+                {
+                    int v = csr.targets[k];
+                    int expected = -1;
+                    if(depthOf[v].load(memory_order_relaxed) == -1 &&
+                       depthOf[v].compare_exchange_strong(expected, depth + 1, memory_order_relaxed))
+                        next.push_back(v);
+                }
+            }
+        }, workers);
+
+        vector<int> next;
+        for(auto &local : localNext)
+            next.insert(next.end(), local.begin(), local.end());
+        if(next.empty()) break;
+        // Bottom-up workers scan ascending id ranges, so only top-down output needs sorting
+        if(!bottomUp) sort(next.begin(), next.end());
+        levels.push_back(move(next));
+        depth++;
+    }
+    return levels;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<vector<T>> DGraphModel<T, Eq, Hash, Fmt>::BFSLevels(T start, int threads, int maxDepth)
+{
+    KG_TIMED("DGraphModel::BFSLevels");
+    auto startnode = getVertexNode(start);
+    if(!startnode) throw VertexNotFoundException("Vertex not found!");
+    vector<vector<T>> result;
+    for(auto &level : levelIds(startnode->id, threads, maxDepth))
+    {
+        result.push_back({});
+        result.back().reserve(level.size());
+        for(int id : level)
+            result.back().push_back(nodeList[id]->vertex);
+    }
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+string DGraphModel<T, Eq, Hash, Fmt>::BFS(T start, int threads)
+{
+    KG_TIMED("DGraphModel::BFS(threads)");
+    auto startnode = getVertexNode(start);
+    if(!startnode) throw VertexNotFoundException("Vertex not found!");
+    string result = "";
+    for(auto &level : levelIds(startnode->id, threads, INT_MAX))
+    {
+        for(int id : level)
+            result += this->vertex2Str(*nodeList[id]) + " ";
+    }
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<vector<T>> DGraphModel<T, Eq, Hash, Fmt>::multiSourceBFS(vector<T> starts, int maxDepth)
+{
+    KG_TIMED("DGraphModel::multiSourceBFS");
+    const int MAX_WORDS = 4;
+    int n = nodeList.size();
+    vector<int> startIds;
+    for(auto &start : starts)
+    {
+        auto node = getVertexNode(start);
+        if(!node) throw VertexNotFoundException("Vertex not found!");
+        startIds.push_back(node->id);
+    }
+
+    vector<vector<T>> result(starts.size());
+    vector<uint64_t> seen;
+    vector<uint64_t> visit;
+    vector<uint64_t> visitNext;
+    vector<int> active;
+    vector<int> nextActive;
+    for(size_t batch = 0; batch < startIds.size(); batch += 64 * MAX_WORDS)
+    {
+        int count = min(startIds.size() - batch, (size_t)64 * MAX_WORDS);
+        int words = (count + 63) / 64;
+        // Bit b of word x in a vertex's mask stands for start batch + 64 * x + b
+        seen.assign((size_t)n * words, 0);
+        visit.assign((size_t)n * words, 0);
+        visitNext.assign((size_t)n * words, 0);
+        active.clear();
+        for(int i = 0; i < count; i++)
+        {
+            int v = startIds[batch + i];
+            bool idle = true;
+            for(int x = 0; x < words; x++)
+                idle = idle && !visit[(size_t)v * words + x];
+            if(idle) active.push_back(v);
+            seen[(size_t)v * words + i / 64] |= 1ULL << (i % 64);
+            visit[(size_t)v * words + i / 64] |= 1ULL << (i % 64);
+        }
+
+        for(int depth = 0; depth < maxDepth && !active.empty(); depth++)
+        {
+            nextActive.clear();
+            KG_COUNT(METRIC_VERTICES_VISITED, active.size());
+            for(int v : active)
+            {
+                uint64_t *from = &visit[(size_t)v * words];
+                auto relax = [&](int w) {
+                    uint64_t *to = &visitNext[(size_t)w * words];
+                    uint64_t *known = &seen[(size_t)w * words];
+                    bool wasIdle = true;
+                    bool gained = false;
+                    for(int x = 0; x < words; x++)
+                    {
+                        wasIdle = wasIdle && !to[x];
+                        uint64_t fresh = from[x] & ~known[x];
+                        gained = gained || fresh;
+                        to[x] |= fresh;
+                    }
+                    if(gained && wasIdle) nextActive.push_back(w);
+                };
+                if(frozen)
+                {
+                    KG_COUNT(METRIC_EDGES_SCANNED, frozen->offsets[v + 1] - frozen->offsets[v]);
+                    for(int k = frozen->offsets[v]; k < frozen->offsets[v + 1]; k++)
+                        relax(frozen->targets[k]);
+                }
+                else
+                {
+                    KG_COUNT(METRIC_EDGES_SCANNED, nodeList[v]->adList.size());
+                    for(auto edge : nodeList[v]->adList)
+                        relax(edge->to->id);
+                }
+            }
+            for(int v : active)
+                fill(visit.begin() + (size_t)v * words, visit.begin() + (size_t)(v + 1) * words, 0);
+
+            sort(nextActive.begin(), nextActive.end());
+            for(int w : nextActive)
+            {
+                for(int x = 0; x < words; x++)
+                {
+                    uint64_t bits = visitNext[(size_t)w * words + x];
+                    seen[(size_t)w * words + x] |= bits;
+                    visit[(size_t)w * words + x] = bits;
+                    visitNext[(size_t)w * words + x] = 0;
+                    while(bits)
+                    {
+                        int b = __builtin_ctzll(bits);
+                        bits &= bits - 1;
+                        result[batch + 64 * x + b].push_back(nodeList[w]->vertex);
+                    }
+                }
+            }
+            active.swap(nextActive);
+        }
+    }
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::dijkstra(int source, int target)
+{
+    int n = nodeList.size();
+    if((int)pathDist.size() < n)
+    {
+        pathDist.resize(n);
+        pathParent.resize(n);
+    }
+    beginVisit();
+    pathHeap.clear();
+    markVisited(source);
+    pathDist[source] = 0;
+    pathParent[source] = -1;
+    pathHeap.push(0, source);
+
+    while(!pathHeap.empty())
+    {
+        pair<float,int> top = pathHeap.pop();
+        int u = top.second;
+        if(top.first > pathDist[u]) continue;
+        if(u == target) break;
+        KG_COUNT(METRIC_VERTICES_VISITED, 1);
+        auto relax = [&](int v, float w) {
+            if(w < 0) throw NegativeWeightException("Negative edge weight!");
+            float candidate = top.first + w;
+            if(markVisited(v) || candidate < pathDist[v])
+            {
+                pathDist[v] = candidate;
+                pathParent[v] = u;
+                pathHeap.push(candidate, v);
+            }
+        };
+        if(frozen)
+        {
+            KG_COUNT(METRIC_EDGES_SCANNED, frozen->offsets[u + 1] - frozen->offsets[u]);
+            for(int k = frozen->offsets[u]; k < frozen->offsets[u + 1]; k++)
+                relax(frozen->targets[k], frozen->weights[k]);
+        }
+        else
+        {
+            KG_COUNT(METRIC_EDGES_SCANNED, nodeList[u]->adList.size());
+            for(auto edge : nodeList[u]->adList)
+                relax(edge->to->id, edge->weight);
+        }
+    }
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<float> DGraphModel<T, Eq, Hash, Fmt>::deltaStepping(int source, int threads)
+{
+    freeze();
+    FrozenGraph<T> &csr = *frozen;
+    int n = csr.size();
+    const float INF = numeric_limits<float>::infinity();
+    // Negative weights are only rejected when relaxed, as in dijkstra(), so the
+    // answer does not depend on edges the source cannot reach
+    double totalWeight = 0;
+    for(float w : csr.weights) totalWeight += max(w, 0.0f);
+    // Bucket width: mean edge weight, so a bucket holds roughly one hop of progress
+    float delta = csr.weights.empty() ? 1.0f : max((float)(totalWeight / csr.weights.size()), 1e-6f);
+
+    WorkerPool &pool = workerPool(threads);
+    int workers = threads;
+    vector<float> dist(n, INF);
+    vector<float> expandedAt(n, -1);    // distance a vertex last had its light edges relaxed with
+    vector<char> inSettled(n, 0);
+    vector<vector<int>> buckets(1);
+    // requests[w][o]: relaxations produced by worker w for vertices owned by worker o
+    vector<vector<vector<pair<int,float>>>> requests(workers, vector<vector<pair<int,float>>>(workers));
+    vector<vector<int>> improved(workers);
+    dist[source] = 0;
+    buckets[0].push_back(source);
+
+    atomic<bool> negative(false);
+    auto bucketOf = [&](float d) { return (size_t)(d / delta); };
+    auto relaxAll = [&](vector<int> &from, bool light) {
+        pool.run([&](int w) {
+            for(auto &out : requests[w]) out.clear();
+            size_t lo = from.size() * w / workers;
+            size_t hi = from.size() * (w + 1) / workers;
+            for(size_t i = lo; i < hi; i++)
+            {
+                int u = from[i];
+                for(int k = csr.offsets[u]; k < csr.offsets[u + 1]; k++)
+                {
+                    if(csr.weights[k] < 0) negative.store(true, memory_order_relaxed);
+                    if((csr.weights[k] <= delta) != light) continue;
+                    int v = csr.targets[k];
+                    requests[w][v % workers].push_back({v, dist[u] + csr.weights[k]});
+                }
+            }
+        }, workers);
+        if(negative.load(memory_order_relaxed)) throw NegativeWeightException("Negative edge weight!");
+        pool.run([&](int o) {
+            improved[o].clear();
+            for(int w = 0; w < workers; w++)
+            {
+                for(auto &request : requests[w][o])
+                {
+                    if(request.second < dist[request.first])
+                    {
+                        dist[request.first] = request.second;
+                        improved[o].push_back(request.first);
+                    }
+                }
+            }
+        }, workers);
+        for(auto &list : improved)
+        {
+            for(int v : list)
+            {
+                size_t b = bucketOf(dist[v]);
+                if(b >= buckets.size()) buckets.resize(b + 1);
+                buckets[b].push_back(v);
+            }
+        }
+    };
+
+    vector<int> frontier;
+    vector<int> settled;
+    for(size_t i = 0; i < buckets.size(); i++)
+    {
+        settled.clear();
+        while(!buckets[i].empty())
+        {
+            frontier.clear();
+            for(int v : buckets[i])
+            {
+                // Skip stale entries: moved to a lower bucket or already expanded at this distance
+                if(bucketOf(dist[v]) != i || expandedAt[v] == dist[v]) continue;
+                expandedAt[v] = dist[v];
+                frontier.push_back(v);
+                if(!inSettled[v])
+                {
+                    inSettled[v] = 1;
+                    settled.push_back(v);
+                }
+            }
+            buckets[i].clear();
+            relaxAll(frontier, true);
+        }
+        relaxAll(settled, false);
+        for(int v : settled) inSettled[v] = 0;
+    }
+    return dist;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+PathResult<T> DGraphModel<T, Eq, Hash, Fmt>::shortestPath(T from, T to)
+{
+    KG_TIMED("DGraphModel::shortestPath");
+    auto temp_from = getVertexNode(from);
+    auto temp_to = getVertexNode(to);
+    if(!temp_from || !temp_to)
+        throw VertexNotFoundException("Vertex not found!");
+    dijkstra(temp_from->id, temp_to->id);
+
+    PathResult<T> result;
+    result.found = isVisited(temp_to);
+    result.distance = result.found ? pathDist[temp_to->id] : numeric_limits<float>::infinity();
+    if(!result.found) return result;
+    for(int v = temp_to->id; v != -1; v = pathParent[v])
+        result.path.push_back(nodeList[v]->vertex);
+    reverse(result.path.begin(), result.path.end());
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+vector<pair<T,float>> DGraphModel<T, Eq, Hash, Fmt>::shortestDistances(T from, int threads)
+{
+    KG_TIMED("DGraphModel::shortestDistances");
+    auto temp_from = getVertexNode(from);
+    if(!temp_from)
+        throw VertexNotFoundException("Vertex not found!");
+    vector<pair<T,float>> result;
+    if(threads > 1)
+    {
+        vector<float> dist = deltaStepping(temp_from->id, threads);
+        for(size_t v = 0; v < dist.size(); v++)
+        {
+            if(dist[v] != numeric_limits<float>::infinity())
+                result.push_back({nodeList[v]->vertex, dist[v]});
+        }
+        return result;
+    }
+    dijkstra(temp_from->id, -1);
+    for(auto node : nodeList)
+    {
+        if(isVisited(node))
+            result.push_back({node->vertex, pathDist[node->id]});
+    }
+    return result;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::save(string path)
+{
+    KG_TIMED("DGraphModel::save");
+    compact();
+    bool temporary = !frozen;
+    FrozenGraph<T> *csr = frozen ? frozen : new FrozenGraph<T>(nodeList);
+    try
+    {
+        csr->write(path, csr->values);
+    }
+    catch(SnapshotException &)
+    {
+        if(temporary) delete csr;
+        throw;
+    }
+    if(temporary) delete csr;
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+void DGraphModel<T, Eq, Hash, Fmt>::load(string path)
+{
+    KG_TIMED("DGraphModel::load");
+    GraphSnapshot<T> snapshot(path, nullptr, true, true);
+    this->clear();
+    int n = snapshot.size();
+    this->reserve(n);
+    for(int id = 0; id < n; id++)
+    {
+        T value = snapshot.getVertex(id);
+        // Two equal values would break the one node per vertex that lookups rely on
+        if(getVertexNode(value))
+        {
+            this->clear();
+            throw SnapshotException("Snapshot repeats a vertex: " + path);
+        }
+        createNode(value);
+    }
+    restoreEdges(snapshot);
+}
+
+template <class T, class Eq, class Hash, class Fmt>
+template <class V>
+void DGraphModel<T, Eq, Hash, Fmt>::restoreEdges(GraphSnapshot<V> &snapshot)
+{
+    int n = snapshot.size();
+    for(int u = 0; u < n; u++)
+    {
+        VertexNode<T> *node = nodeList[u];
+        node->adList.reserve(snapshot.offsets[u + 1] - snapshot.offsets[u]);
+        for(int k = snapshot.offsets[u]; k < snapshot.offsets[u + 1]; k++)
+            node->connect(nodeList[snapshot.targets[k]], snapshot.weights[k], snapshot.labels[k]);
+    }
+    // connect() appended in-edges by source id; restore the saved inList order
+    vector<pair<int,int>> slots;
+    vector<Edge<T>*> ordered;
+    for(int v = 0; v < n; v++)
+    {
+        int first = snapshot.inOffsets[v];
+        restoreInOrder(nodeList[v]->inList, [&](int i) { return snapshot.sources[first + i]; }, slots, ordered);
+        // The label groups were filled in connect() order too
+        if(nodeList[v]->partitions)
+        {
+            delete nodeList[v]->partitions;
+            nodeList[v]->partition();
+        }
+    }
+}
+
+// TODO: Implement other methods of DGraphModel:
+
+// =============================================================================
+// Class KnowledgeGraph Implementation
+// =============================================================================
+
+bool KnowledgeGraph::stringEQ(string &a, string &b)
+{
+    return a == b;
+}
+
+string KnowledgeGraph::string2str(string &a)
+{
+    return a;
+}
+
+size_t KnowledgeGraph::stringHash(string &a)
+{
+    return std::hash<string>()(a);
+}
+
+KnowledgeGraph::KnowledgeGraph() {
+    this->published.store(nullptr);
+    this->versions = 0;
+    // Vertex values are symbol ids, so they follow the nodes' new ids
+    graph.renumbered = [this](int a, int b) {
+        graph.nodeList[a]->vertex = a;
+        graph.nodeList[b]->vertex = b;
+        symbols.swap(a, b);
+    };
+}
+
+KnowledgeGraph::~KnowledgeGraph() {
+    delete this->published.load();
+}
+
+VertexNode<uint32_t>* KnowledgeGraph::createEntity(string_view name)
+{
+    uint32_t id = symbols.intern(name);
+    return graph.createNode(id);
+}
+
+VertexNode<uint32_t>* KnowledgeGraph::entityNode(string &entity)
+{
+    uint32_t id = symbols.find(entity);
+    if(id == SymbolTable::npos)
+        throw EntityNotFoundException("Entity not found!");
+    return graph.nodeList[id];
+}
+
+VertexNode<uint32_t>* KnowledgeGraph::entityNode(uint32_t id)
+{
+    if(id >= symbols.size() || graph.nodeList[id]->removed)
+        throw EntityNotFoundException("Entity not found!");
+    return graph.nodeList[id];
+}
+
+vector<string> KnowledgeGraph::names(const vector<uint32_t> &ids)
+{
+    vector<string> result;
+    result.reserve(ids.size());
+    for(auto id : ids)
+        result.emplace_back(symbols.name(id));
+    return result;
+}
+
+string KnowledgeGraph::joinNames(const vector<uint32_t> &ids)
+{
+    string result = "";
+    for(auto id : ids)
+    {
+        result += symbols.name(id);
+        result += " ";
+    }
+    if(!result.empty()) result.pop_back();
+    return result;
+}
+
+void KnowledgeGraph::addEntity(string entity)
+{
+    KG_TIMED("KnowledgeGraph::addEntity");
+    if(symbols.find(entity) != SymbolTable::npos)
+        throw EntityExistsException("Entity already exists!");
+    createEntity(entity);
+}
+
+void KnowledgeGraph::addRelation(string from, string to, float weight)
+{
+    KG_TIMED("KnowledgeGraph::addRelation");
+    auto from_node = entityNode(from);
+    auto to_node = entityNode(to);
+    graph.connect(from_node->vertex, to_node->vertex, weight);
+}
+
+void KnowledgeGraph::addRelation(string from, string to, float weight, string label)
+{
+    KG_TIMED("KnowledgeGraph::addRelation(label)");
+    auto from_node = entityNode(from);
+    auto to_node = entityNode(to);
+    uint32_t id = label.empty() ? 0 : labels.intern(label) + 1;
+    graph.connect(from_node->vertex, to_node->vertex, weight, id);
+}
+
+string KnowledgeGraph::relationLabel(string from, string to)
+{
+    KG_TIMED("KnowledgeGraph::relationLabel");
+    auto from_node = entityNode(from);
+    auto to_node = entityNode(to);
+    uint32_t id = graph.label(from_node->vertex, to_node->vertex);
+    if(id == 0) return "";
+    return string(labels.name(id - 1));
+}
+
+vector<string> KnowledgeGraph::relationLabels(string from, string to)
+{
+    KG_TIMED("KnowledgeGraph::relationLabels");
+    auto from_node = entityNode(from);
+    auto to_node = entityNode(to);
+    vector<string> result;
+    for(auto edge : from_node->adList)
+    {
+        if(edge->to != to_node) continue;
+        if(edge->label == 0) result.emplace_back("");
+        else result.emplace_back(labels.name(edge->label - 1));
+    }
+    return result;
+}
+
+bool KnowledgeGraph::findLabel(string &label, uint32_t &id)
+{
+    if(label.empty())
+    {
+        id = 0;
+        return true;
+    }
+    uint32_t found = labels.find(label);
+    if(found == SymbolTable::npos) return false;
+    id = found + 1;
+    return true;
+}
+
+void KnowledgeGraph::removeEntity(string entity)
+{
+    KG_TIMED("KnowledgeGraph::removeEntity");
+    uint32_t id = entityNode(entity)->vertex;
+    graph.remove(id);
+    symbols.remove(id);
+}
+
+bool KnowledgeGraph::compact(int budget)
+{
+    KG_TIMED("KnowledgeGraph::compact");
+    bool done = graph.compact(budget);
+    // A finished pass dropped the removed nodes from the end of the id space
+    if(symbols.size() > graph.nodeList.size())
+        symbols.truncate(graph.nodeList.size());
+    return done;
+}
+
+void KnowledgeGraph::reorder(VertexLayout layout)
+{
+    KG_TIMED("KnowledgeGraph::reorder");
+    graph.reorder(layout);
+}
+
+BulkLoadReport KnowledgeGraph::addEntities(const vector<string> &names)
+{
+    KG_TIMED("KnowledgeGraph::addEntities");
+    BulkLoadReport report;
+    report.accepted = 0;
+    size_t bytes = 0;
+    for(auto &name : names) bytes += name.size();
+    graph.reserve(graph.nodeList.size() + names.size());
+    symbols.reserve(symbols.size() + names.size(), bytes);
+    for(size_t row = 0; row < names.size(); row++)
+    {
+        if(symbols.find(names[row]) != SymbolTable::npos)
+        {
+            report.rejected.push_back({row, "Entity already exists!"});
+            continue;
+        }
+        createEntity(names[row]);
+        report.accepted++;
+    }
+    return report;
+}
+
+BulkLoadReport KnowledgeGraph::addRelations(const vector<tuple<string, string, float>> &relations)
+{
+    KG_TIMED("KnowledgeGraph::addRelations");
+    BulkLoadReport report;
+    report.accepted = 0;
+
+    // Resolve every endpoint once; unresolved rows stay null and are skipped
+    vector<pair<VertexNode<uint32_t>*, VertexNode<uint32_t>*>> endpoints(relations.size());
+    for(size_t row = 0; row < relations.size(); row++)
+    {
+        uint32_t from = symbols.find(get<0>(relations[row]));
+        uint32_t to = symbols.find(get<1>(relations[row]));
+        if(from == SymbolTable::npos || to == SymbolTable::npos)
+        {
+            report.rejected.push_back({row, "Entity not found!"});
+            continue;
+        }
+        endpoints[row] = {graph.nodeList[from], graph.nodeList[to]};
+    }
+    vector<float> weights(relations.size());
+    for(size_t row = 0; row < relations.size(); row++)
+    {
+        weights[row] = get<2>(relations[row]);
+        if(endpoints[row].first) report.accepted++;
+    }
+    connectBulk(endpoints, weights);
+    return report;
+}
+
+void KnowledgeGraph::connectBulk(vector<pair<VertexNode<uint32_t>*, VertexNode<uint32_t>*>> &endpoints, vector<float> &weights)
+{
+    // Presize the adjacency lists, then connect without further lookups; null rows are skipped.
+    // A batch that is small next to the graph counts degrees in a map, so it
+    // costs O(rows) rather than a pass over every node.
+    if(endpoints.size() * 8 >= graph.nodeList.size())
+    {
+        vector<int> extraOut(graph.nodeList.size(), 0);
+        vector<int> extraIn(graph.nodeList.size(), 0);
+        for(auto &row : endpoints)
+        {
+            if(!row.first) continue;
+            extraOut[row.first->id]++;
+            extraIn[row.second->id]++;
+        }
+        for(auto node : graph.nodeList)
+        {
+            if(extraOut[node->id]) node->adList.reserve(node->adList.size() + extraOut[node->id]);
+            if(extraIn[node->id]) node->inList.reserve(node->inList.size() + extraIn[node->id]);
+        }
+    }
+    else
+    {
+        unordered_map<VertexNode<uint32_t>*, pair<int,int>> extra;    // node -> (out, in)
+        extra.reserve(2 * endpoints.size());
+        for(auto &row : endpoints)
+        {
+            if(!row.first) continue;
+            extra[row.first].first++;
+            extra[row.second].second++;
+        }
+        for(auto &it : extra)
+        {
+            VertexNode<uint32_t> *node = it.first;
+            if(it.second.first) node->adList.reserve(node->adList.size() + it.second.first);
+            if(it.second.second) node->inList.reserve(node->inList.size() + it.second.second);
+        }
+    }
+
+    graph.thaw();
+    graph.reach.invalidate();
+    graph.ancestors.invalidate();
+    for(size_t row = 0; row < endpoints.size(); row++)
+    {
+        auto from_node = endpoints[row].first;
+        auto to_node = endpoints[row].second;
+        if(!from_node) continue;
+        if(!from_node->getEdge(to_node, 0))
+            from_node->connect(to_node, weights[row]);
+    }
+}
+
+// Descriptor and mapping of an import file, released however importEdgeList exits
+struct ImportFile {
+    int fd;
+    void *mapping;
+    size_t size;
+
+    ImportFile() : fd(-1), mapping(nullptr), size(0) {}
+    ~ImportFile()
+    {
+        if(mapping) munmap(mapping, size);
+        if(fd >= 0) close(fd);
+    }
+};
+
+ImportReport KnowledgeGraph::importEdgeList(string path, char delimiter, int threads)
+{
+    KG_TIMED("KnowledgeGraph::importEdgeList");
+    auto begin = chrono::steady_clock::now();
+    ImportReport report;
+    report.lines = 0;
+    report.relations = 0;
+    report.entitiesAdded = 0;
+    report.bytes = 0;
+
+    ImportFile file;
+    file.fd = open(path.c_str(), O_RDONLY);
+    if(file.fd < 0) throw ImportException("Cannot open import file: " + path);
+    struct stat info;
+    if(fstat(file.fd, &info) != 0) throw ImportException("Cannot read import file: " + path);
+    size_t size = info.st_size;
+    const char *data = nullptr;
+    if(size > 0)
+    {
+        void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+        if(mapping == MAP_FAILED) throw ImportException("Cannot map import file: " + path);
+        file.mapping = mapping;
+        file.size = size;
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapping);
+    }
+    report.bytes = size;
+
+    // Cut the file into one chunk per worker at line boundaries
+    int workers = max(threads, 1);
+    WorkerPool &pool = graph.workerPool(workers);
+    vector<size_t> cuts(workers + 1, size);
+    cuts[0] = 0;
+    for(int w = 1; w < workers; w++)
+    {
+        size_t pos = max(size * w / workers, cuts[w - 1]);
+        // A file smaller than the worker count leaves the first cuts at 0, the start of a line
+        while(pos > 0 && pos < size && data[pos - 1] != '\n') pos++;
+        cuts[w] = pos;
+    }
+
+    struct ParsedRow {
+        string_view from;
+        string_view to;
+        float weight;
+    };
+    vector<vector<ParsedRow>> rows(workers);
+    vector<vector<pair<size_t, string>>> errors(workers);
+    vector<size_t> lineCounts(workers, 0);
+    pool.run([&](int w) {
+        size_t pos = cuts[w];
+        size_t line = 0;
+        while(pos < cuts[w + 1])
+        {
+            const char *lineStart = data + pos;
+            const char *lineEnd = static_cast<const char*>(memchr(lineStart, '\n', cuts[w + 1] - pos));
+            if(!lineEnd) lineEnd = data + cuts[w + 1];
+            pos = lineEnd - data + 1;
+            line++;
+            string_view text(lineStart, lineEnd - lineStart);
+            if(!text.empty() && text.back() == '\r') text.remove_suffix(1);
+            if(text.empty() || text[0] == '#') continue;
+
+            string_view fields[3];
+            int count = 0;
+            size_t start = 0;
+            while(count < 3)
+            {
+                size_t cut = text.find(delimiter, start);
+                fields[count++] = text.substr(start, cut == string_view::npos ? string_view::npos : cut - start);
+                if(cut == string_view::npos)
+                {
+                    start = text.size() + 1;
+                    break;
+                }
+                start = cut + 1;
+            }
+            if(start <= text.size())
+            {
+                errors[w].push_back({line, "Too many fields"});
+                continue;
+            }
+            if(count < 2 || fields[0].empty() || fields[1].empty())
+            {
+                errors[w].push_back({line, "Missing entity name"});
+                continue;
+            }
+            float weight = 1.0f;
+            if(count == 3)
+            {
+                auto parsed = from_chars(fields[2].data(), fields[2].data() + fields[2].size(), weight);
+                if(parsed.ec != errc() || parsed.ptr != fields[2].data() + fields[2].size())
+                {
+                    errors[w].push_back({line, "Invalid weight"});
+                    continue;
+                }
+            }
+            rows[w].push_back({fields[0], fields[1], weight});
+        }
+        lineCounts[w] = line;
+    }, workers);
+
+    // Resolve names chunk by chunk in file order, straight from the mapped bytes
+    size_t total = 0;
+    for(auto &chunk : rows) total += chunk.size();
+    auto resolve = [&](string_view name) {
+        uint32_t id = symbols.find(name);
+        if(id != SymbolTable::npos) return graph.nodeList[id];
+        report.entitiesAdded++;
+        return createEntity(name);
+    };
+    vector<pair<VertexNode<uint32_t>*, VertexNode<uint32_t>*>> endpoints;
+    vector<float> weights;
+    endpoints.reserve(total);
+    weights.reserve(total);
+    size_t lineBase = 0;
+    for(int w = 0; w < workers; w++)
+    {
+        for(auto &row : rows[w])
+        {
+            auto from_node = resolve(row.from);
+            endpoints.push_back({from_node, resolve(row.to)});
+            weights.push_back(row.weight);
+        }
+        for(auto &error : errors[w])
+            report.errors.push_back({lineBase + error.first, error.second});
+        lineBase += lineCounts[w];
+    }
+    connectBulk(endpoints, weights);
+
+    report.lines = lineBase;
+    report.relations = endpoints.size();
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    report.megabytesPerSecond = report.seconds > 0 ? size / 1e6 / report.seconds : 0;
+    return report;
+}
+
+vector<string> KnowledgeGraph::getAllEntities()
+{
+    KG_TIMED("KnowledgeGraph::getAllEntities");
+    vector<string> result;
+    result.reserve(symbols.size());
+    for(uint32_t id = 0; id < symbols.size(); id++)
+    {
+        if(!graph.nodeList[id]->removed) result.emplace_back(symbols.name(id));
+    }
+    return result;
+}
+
+vector<string> KnowledgeGraph::getNeighbors(string entity)
+{
+    KG_TIMED("KnowledgeGraph::getNeighbors");
+    return names(neighbors(entityNode(entity)->vertex));
+}
+
+vector<string> KnowledgeGraph::getNeighbors(string entity, string label)
+{
+    KG_TIMED("KnowledgeGraph::getNeighbors(label)");
+    auto node = entityNode(entity);
+    vector<string> result;
+    uint32_t id;
+    if(!findLabel(label, id)) return result;
+    auto edges = node->outEdges(id);
+    if(!edges) return result;
+    result.reserve(edges->size());
+    for(auto edge : *edges)
+        result.emplace_back(symbols.name(edge->to->vertex));
+    return result;
 }
 
-template <class T>
-int VertexNode<T>::inDegree()
+string KnowledgeGraph::bfs(string start)
 {
-    return inDegree_;
+    KG_TIMED("KnowledgeGraph::bfs");
+    return joinNames(bfs(entityNode(start)->vertex));
 }
 
-template <class T>
-int VertexNode<T>::outDegree()
+string KnowledgeGraph::bfs(string start, string label)
 {
-    return outDegree_;
+    KG_TIMED("KnowledgeGraph::bfs(label)");
+    auto startnode = entityNode(start);
+    uint32_t id;
+    if(!findLabel(label, id)) return start;
+    vector<uint32_t> result;
+    graph.traverseBFS(startnode->vertex, [&](VertexNode<uint32_t> &node, int, VertexNode<uint32_t>*) {
+        result.push_back(node.vertex);
+        return true;
+    }, id);
+    return joinNames(result);
 }
 
-template <class T>
-string VertexNode<T>::toString()
+string KnowledgeGraph::dfs(string start)
 {
-    stringstream ss;
-    ss << this->getVertex() << " " << this->inDegree() << " " << this->outDegree();
-    return ss.str();
+    KG_TIMED("KnowledgeGraph::dfs");
+    return joinNames(dfs(entityNode(start)->vertex));
 }
-// =============================================================================
-// Class DGraphModel Implementation
-// =============================================================================
 
-template <class T>
-bool DGraphModel<T>::checkequal(T &node1, T &node2)
+void KnowledgeGraph::bfs(string start, function<bool(string&, int, string*)> visit)
 {
-    if(vertexEQ) return vertexEQ(node1, node2);
-    return node1 == node2;
+    KG_TIMED("KnowledgeGraph::bfs(visitor)");
+    auto startnode = entityNode(start);
+    graph.traverseBFS(startnode->vertex, [&](VertexNode<uint32_t> &node, int depth, VertexNode<uint32_t> *parent) {
+        string name(symbols.name(node.vertex));
+        if(!parent) return visit(name, depth, nullptr);
+        string parent_name(symbols.name(parent->vertex));
+        return visit(name, depth, &parent_name);
+    });
 }
 
-template <class T>
-DGraphModel<T>::DGraphModel(bool (*vertexEQ)(T&, T&), string (*vertex2str)(T&)) {
-    this->vertexEQ = vertexEQ;
-    this->vertex2str = vertex2str;
+void KnowledgeGraph::dfs(string start, function<bool(string&, int, string*)> visit)
+{
+    KG_TIMED("KnowledgeGraph::dfs(visitor)");
+    auto startnode = entityNode(start);
+    graph.traverseDFS(startnode->vertex, [&](VertexNode<uint32_t> &node, int depth, VertexNode<uint32_t> *parent) {
+        string name(symbols.name(node.vertex));
+        if(!parent) return visit(name, depth, nullptr);
+        string parent_name(symbols.name(parent->vertex));
+        return visit(name, depth, &parent_name);
+    });
 }
 
-template <class T>
-DGraphModel<T>::~DGraphModel() {
-    // TODO: Clear all vertices and edges to avoid memory leaks
-    this->clear();
+bool KnowledgeGraph::isReachable(string from, string to)
+{
+    KG_TIMED("KnowledgeGraph::isReachable");
+    auto from_node = entityNode(from);
+    auto to_node = entityNode(to);
+    return isReachable(from_node->vertex, to_node->vertex);
 }
 
-template <class T>
-VertexNode<T>* DGraphModel<T>::getVertexNode(T &vertex)
+string KnowledgeGraph::toString()
 {
-    for(auto it : nodeList)
+    KG_TIMED("KnowledgeGraph::toString");
+    string result = "";
+    for(auto node : graph.nodeList)
     {
-        if(vertexEQ)
+        if(node->removed) continue;
+        string_view name = symbols.name(node->vertex);
+        result += "Vertex: ";
+        result += name;
+        result += "\n";
+        if(!node->adList.empty())
         {
-            if(vertexEQ(it->vertex, vertex))
+            result += "  Edges:\n";
+            for(auto edge : node->adList)
             {
-                return it;
+                result += "    -> ";
+                result += name;
+                result += "->";
+                result += symbols.name(edge->to->vertex);
+                result += "\n";
             }
         }
-        else if(it->vertex == vertex) return it;
     }
-    return nullptr;
+    return result;
 }
 
-template <class T>
-string DGraphModel<T>::vertex2Str(VertexNode<T> &node)
+void KnowledgeGraph::freeze()
 {
-    if(vertex2str)
-        return vertex2str(node.getVertex());
-    return "";
+    KG_TIMED("KnowledgeGraph::freeze");
+    graph.freeze();
 }
 
-template <class T>
-string DGraphModel<T>::edge2Str(Edge<T> &edge)
+void KnowledgeGraph::thaw()
 {
-    stringstream ss;
-    ss << this->vertex2Str(*edge.from) << "->" << this->vertex2Str(*edge.to);
-    return ss.str();
+    graph.thaw();
 }
 
-template <class T>
-void DGraphModel<T>::add(T vertex) 
+MemoryUsage KnowledgeGraph::memoryUsage()
 {
-    if(this->getVertexNode(vertex)) return;
-    VertexNode<T> *newnode = new VertexNode<T>(vertex, vertexEQ, vertex2str);
-    this->nodeList.push_back(newnode);
+    KG_TIMED("KnowledgeGraph::memoryUsage");
+    MemoryUsage usage = graph.memoryUsage();
+    usage.strings += symbols.arenaBytes() + labels.arenaBytes();
+    usage.indexes += symbols.indexBytes() + labels.indexBytes();
+    GraphVersion<string> *version = published.load();
+    if(version) usage.derived += version->bytes();
+    return usage;
 }
 
-template <class T>
-bool DGraphModel<T>::contains(T vertex)
+void KnowledgeGraph::shrinkToFit()
 {
-    return this->getVertexNode(vertex);
+    KG_TIMED("KnowledgeGraph::shrinkToFit");
+    graph.shrinkToFit();
+    symbols.shrinkToFit();
+    labels.shrinkToFit();
 }
 
-template <class T>
-float DGraphModel<T>::weight(T from, T to)
+uint64_t KnowledgeGraph::publish()
 {
-    auto temp_from = getVertexNode(from);
-    auto temp_to = getVertexNode(to);
-    if(!temp_from || !temp_to)
-        throw VertexNotFoundException("Vertex not found!");
-    auto edge = temp_from->getEdge(temp_to);
-    if(!edge)
-        throw EdgeNotFoundException("Edge not found!");
-    return edge->weight;
+    KG_TIMED("KnowledgeGraph::publish");
+    compact();
+    auto version = new GraphVersion<string>(graph.nodeList, [&](uint32_t &id) { return string(symbols.name(id)); },
+                                            ++versions, stringEQ, string2str, stringHash, labels);
+    GraphVersion<string> *old = published.exchange(version);
+    if(old) epochs.retire([old]() { delete old; });
+    return versions;
 }
 
-template <class T>
-vector<T> DGraphModel<T>::getOutwardEdges(T from)
+ReadView<string> KnowledgeGraph::reader()
 {
-    vector<T> result;
-    VertexNode<T> *node = getVertexNode(from);
-    if(!node) throw VertexNotFoundException("Vertex not found!" + this->vertex2Str(*node));
-    for(auto it : node->adList)
-    {
-        result.push_back(it->to->getVertex());
-    }
-    return result;
+    return ReadView<string>(&epochs, published);
 }
 
-template <class T>
-void DGraphModel<T>::connect(T from, T to, float weight) 
+vector<string> KnowledgeGraph::getRelatedEntities(string entity, int depth)
 {
-    auto temp_from = getVertexNode(from);
-    auto temp_to = getVertexNode(to);
-    if(!temp_from)
-        throw VertexNotFoundException("Vertex not found!" + this->vertex2Str(*temp_from));
-    if(!temp_to)
-        throw VertexNotFoundException("Vertex not found!" + this->vertex2Str(*temp_to));
-    if(this->connected(from, to)) return;
-
-    temp_from->connect(temp_to, weight);
+    KG_TIMED("KnowledgeGraph::getRelatedEntities");
+    return names(getRelatedEntities(entityNode(entity)->vertex, depth));
 }
 
-template <class T>
-void DGraphModel<T>::disconnect(T from, T to)
+vector<string> KnowledgeGraph::getRelatedEntities(string entity, int depth, int threads)
 {
-    auto temp_from = getVertexNode(from);
-    auto temp_to = getVertexNode(to);
-    if(!temp_from)
-        throw VertexNotFoundException("Vertex not found!" + this->vertex2Str(*temp_from));
-    if(!temp_to)
-        throw VertexNotFoundException("Vertex not found!" + this->vertex2Str(*temp_to));
-    if(this->connected(from, to))
+    KG_TIMED("KnowledgeGraph::getRelatedEntities(threads)");
+    auto startnode = entityNode(entity);
+    vector<vector<uint32_t>> levels = graph.BFSLevels(startnode->vertex, threads, depth);
+    vector<string> result;
+    for(size_t i = 1; i < levels.size(); i++)
     {
-        temp_from->removeTo(temp_to);
+        for(auto id : levels[i])
+            result.emplace_back(symbols.name(id));
     }
+    return result;
 }
 
-template <class T>
-bool DGraphModel<T>::connected(T from, T to)
+vector<string> KnowledgeGraph::getRelatedEntities(string entity, int depth, string label)
 {
-    auto temp_from = getVertexNode(from);
-    auto temp_to = getVertexNode(to);
-    if(!temp_from)
-        throw VertexNotFoundException("Vertex not found!" + this->vertex2Str(*temp_from));
-    if(!temp_to)
-        throw VertexNotFoundException("Vertex not found!" + this->vertex2Str(*temp_to));
-    return temp_from->getEdge(temp_to);
+    KG_TIMED("KnowledgeGraph::getRelatedEntities(label)");
+    auto startnode = entityNode(entity);
+    vector<uint32_t> result;
+    uint32_t id;
+    if(!findLabel(label, id)) return names(result);
+    graph.traverseBFS(startnode->vertex, [&](VertexNode<uint32_t> &node, int current_depth, VertexNode<uint32_t>*) {
+        if(current_depth > depth) return false;
+        if(current_depth > 0) result.push_back(node.vertex);
+        return true;
+    }, id);
+    return names(result);
 }
 
-template <class T>
-int DGraphModel<T>::size()
+vector<vector<string>> KnowledgeGraph::getRelatedEntitiesBatch(vector<string> entities, int depth)
 {
-    return nodeList.size();
+    KG_TIMED("KnowledgeGraph::getRelatedEntitiesBatch");
+    vector<uint32_t> seeds;
+    seeds.reserve(entities.size());
+    for(auto &entity : entities)
+        seeds.push_back(entityNode(entity)->vertex);
+    vector<vector<uint32_t>> related = graph.multiSourceBFS(seeds, depth);
+    vector<vector<string>> result;
+    result.reserve(related.size());
+    for(auto &ids : related)
+        result.push_back(names(ids));
+    return result;
 }
 
-template <class T>
-bool DGraphModel<T>::empty()
+string KnowledgeGraph::findCommonAncestors(string entity1, string entity2)
 {
-    return this->size() == 0;
+    KG_TIMED("KnowledgeGraph::findCommonAncestors");
+    auto node1 = entityNode(entity1);
+    auto node2 = entityNode(entity2);
+    uint32_t result;
+    if(!graph.nearestCommonAncestor(node1->vertex, node2->vertex, result)) return "No common ancestor";
+    return string(symbols.name(result));
 }
 
-template <class T>
-void DGraphModel<T>::clear()
+string KnowledgeGraph::findCommonAncestors(string entity1, string entity2, string label)
 {
-   for(auto node : nodeList)
-   {
-    for(auto edge : node->adList)
-    {
-        delete edge;
-    }
-    node->adList.clear();
-    delete node;
-   }
-   this->nodeList.clear();
+    KG_TIMED("KnowledgeGraph::findCommonAncestors(label)");
+    auto node1 = entityNode(entity1);
+    auto node2 = entityNode(entity2);
+    uint32_t id, result;
+    if(!findLabel(label, id) || !graph.nearestCommonAncestor(node1->vertex, node2->vertex, result, id))
+        return "No common ancestor";
+    return string(symbols.name(result));
 }
 
-template <class T>
-int DGraphModel<T>::inDegree(T vertex)
+bool KnowledgeGraph::buildAncestorIndex()
 {
-    auto node = getVertexNode(vertex);
-    if(!node) throw VertexNotFoundException("Vertex not found!");
-    return node->inDegree_;
+    KG_TIMED("KnowledgeGraph::buildAncestorIndex");
+    return graph.buildAncestorIndex();
 }
 
-template <class T>
-int DGraphModel<T>::outDegree(T vertex)
+void KnowledgeGraph::save(string path)
 {
-    auto node = getVertexNode(vertex);
-    if(!node) throw VertexNotFoundException("Vertex not found!");
-    return node->outDegree_;
+    KG_TIMED("KnowledgeGraph::save");
+    compact();
+    // Written with the names as values, so the file reads back as a GraphSnapshot<string>
+    vector<string_view> values;
+    values.reserve(symbols.size());
+    for(uint32_t id = 0; id < symbols.size(); id++)
+        values.push_back(symbols.name(id));
+    vector<string_view> labelNames;
+    labelNames.reserve(labels.size());
+    for(uint32_t id = 0; id < labels.size(); id++)
+        labelNames.push_back(labels.name(id));
+    bool temporary = !graph.frozen;
+    FrozenGraph<uint32_t> *csr = graph.frozen ? graph.frozen : new FrozenGraph<uint32_t>(graph.nodeList);
+    try
+    {
+        csr->write(path, values, labelNames);
+    }
+    catch(SnapshotException &)
+    {
+        if(temporary) delete csr;
+        throw;
+    }
+    if(temporary) delete csr;
 }
 
-template <class T>
-vector<T> DGraphModel<T>::vertices()
+void KnowledgeGraph::load(string path)
 {
-    vector<T> result;
-    for(auto node : nodeList)
+    KG_TIMED("KnowledgeGraph::load");
+    GraphSnapshot<string> snapshot(path, nullptr, true, true);
+    uint32_t labelCount = snapshot.labelCount();
+    for(int k = 0; k < snapshot.edgeCount(); k++)
     {
-        result.push_back(node->getVertex());
+        if(snapshot.labels[k] > labelCount) throw SnapshotException("Snapshot edge label has no name: " + path);
     }
-    return result;
+    SymbolTable names;
+    for(uint32_t label = 1; label <= labelCount; label++)
+        names.intern(snapshot.labelName(label));
+    if(names.size() != labelCount) throw SnapshotException("Snapshot repeats a label name: " + path);
+    // Interning in file order hands out ids 0 .. n-1, so symbol id == node id
+    // holds unless a name repeats
+    int n = snapshot.size();
+    SymbolTable entities;
+    entities.reserve(n);
+    for(int id = 0; id < n; id++)
+        entities.intern(snapshot.getVertex(id));
+    if(entities.size() != (uint32_t)n) throw SnapshotException("Snapshot repeats an entity name: " + path);
+    graph.clear();
+    symbols = move(entities);
+    labels = move(names);
+    graph.reserve(n);
+    for(uint32_t id = 0; id < (uint32_t)n; id++)
+        graph.createNode(id);
+    graph.restoreEdges(snapshot);
 }
 
-template <class T>
-string DGraphModel<T>::toString() {
-    string result = "";
-    for (VertexNode<T>* node : this->nodeList) {
-        string nodeStr = this->vertex2Str(*node); 
-        result += "Vertex: " + nodeStr + "\n";
-        if (!node->adList.empty()) {
-            result += "  Edges:\n";
-            for (Edge<T>* edge : node->adList) {
-                // Sử dụng hàm edge2Str của DGraphModel để lấy chuỗi biểu diễn cạnh
-                result += "    -> " + this->edge2Str(*edge) + "\n"; 
-            }
-        }
-    }
+PathResult<string> KnowledgeGraph::shortestPath(string from, string to)
+{
+    KG_TIMED("KnowledgeGraph::shortestPath");
+    auto from_node = entityNode(from);
+    auto to_node = entityNode(to);
+    PathResult<uint32_t> found = graph.shortestPath(from_node->vertex, to_node->vertex);
+    PathResult<string> result;
+    result.found = found.found;
+    result.distance = found.distance;
+    result.path = names(found.path);
     return result;
 }
 
-template <class T>
-string DGraphModel<T>::BFS(T start)
+vector<pair<string,float>> KnowledgeGraph::shortestDistances(string from, int threads)
 {
-    if(!this->contains(start)) throw VertexNotFoundException("Vertex not found!");
-    auto startnode = getVertexNode(start);
-    vector<VertexNode<T>*> visited;
-    vector<VertexNode<T>*> queues;
-    int currentidx = 0;
-    visited.push_back(startnode);
-    queues.push_back(startnode);
-    string result = "";
-
-    while(currentidx < queues.size())
-    {
-        auto current = queues[currentidx];
-        currentidx++;
-        result += this->vertex2Str(*current) + " ";
-
-        for(auto edge : current->adList)
-        {
-            auto neighbor = edge->to;
-            bool isvisited = false;
-            
-            for(auto v : visited)
-            {
-                if(v == neighbor)
-                {
-                    isvisited = true;
-                    break;
-                }
-            }
-
-            if(!isvisited)
-            {
-                visited.push_back(neighbor);
-                queues.push_back(neighbor);
-            }
-        }
-    }
-
-    if(!result.empty()) result.pop_back();
+    KG_TIMED("KnowledgeGraph::shortestDistances");
+    auto from_node = entityNode(from);
+    vector<pair<uint32_t,float>> distances = graph.shortestDistances(from_node->vertex, threads);
+    vector<pair<string,float>> result;
+    result.reserve(distances.size());
+    for(auto &item : distances)
+        result.push_back({string(symbols.name(item.first)), item.second});
     return result;
 }
 
-template <class T>
-string DGraphModel<T>::DFS(T start)
+vector<pair<string,int>> KnowledgeGraph::collectancestor(string &start)
 {
-    if(!this->contains(start)) throw VertexNotFoundException("Vertex not found!");
-    auto startnode = getVertexNode(start);
-    vector<VertexNode<T>*> visited;
-    vector<VertexNode<T>*> stacks;
-    stacks.push_back(startnode);
-    stringstream temp;
-
-    while(!stacks.empty())
+    KG_TIMED("KnowledgeGraph::collectancestor");
+    vector<pair<string,int>> result;
+    uint32_t startid = symbols.find(start);
+    if(startid == SymbolTable::npos) return result;
+    auto startnode = graph.nodeList[startid];
+    graph.beginVisit();
+    if(graph.frozen)
     {
-        auto current = stacks.back();
-        stacks.pop_back();
-
-        bool isvisited = false;
-        for(auto v : visited)
+        FrozenGraph<uint32_t> *csr = graph.frozen;
+        vector<pair<int,int>> idqueue;
+        graph.markVisited(startnode->id);
+        idqueue.push_back({startnode->id, 0});
+        for(size_t i = 0; i < idqueue.size(); i++)
         {
-            if(v == current)
+            int current = idqueue[i].first;
+            int current_dist = idqueue[i].second;
+            if(current != startnode->id)
+                result.push_back({string(symbols.name(csr->values[current])), current_dist});
+            for(int k = csr->inOffsets[current]; k < csr->inOffsets[current + 1]; k++)
             {
-                isvisited = true;
-                break;
+                if(graph.markVisited(csr->sources[k]))
+                    idqueue.push_back({csr->sources[k], current_dist + 1});
             }
         }
-        if(!isvisited)
-        {
-            visited.push_back(current);
-            temp << this->vertex2Str(*current) << " ";
-        }
-        for(auto it = current->adList.rbegin(); it != current->adList.rend(); it++)
+        return result;
+    }
+    vector<pair<VertexNode<uint32_t>*,int>> queues;
+    size_t count = 0;
+    graph.markVisited(startnode);
+    queues.push_back({startnode,0});
+    while(count < queues.size())
+    {
+        pair<VertexNode<uint32_t>*,int> current = queues[count++];
+        VertexNode<uint32_t> *current_node = current.first;
+        int current_dist = current.second;
+
+        if(current_node != startnode)
+            result.push_back({string(symbols.name(current_node->vertex)), current_dist});
+        for(auto edge : current_node->inList)
         {
-            auto edge = *it;
-            auto neighbor = edge->to;
-            stacks.push_back(neighbor);
+            if(graph.markVisited(edge->from))
+                queues.push_back({edge->from,current_dist + 1});
         }
     }
-    string result = temp.str();
-    if(!result.empty()) result.pop_back();
     return result;
 }
 
-// TODO: Implement other methods of DGraphModel:
-
-// =============================================================================
-// Class KnowledgeGraph Implementation
-// =============================================================================
-
-bool KnowledgeGraph::stringEQ(string &a, string &b)
+int KnowledgeGraph::entityCount()
 {
-    return a == b;
+    return graph.size();
 }
 
-string KnowledgeGraph::string2str(string &a)
+uint32_t KnowledgeGraph::idOf(string entity)
 {
-    return a;
+    return entityNode(entity)->vertex;
 }
 
-KnowledgeGraph::KnowledgeGraph() : graph(stringEQ, string2str) {}
-
-void KnowledgeGraph::addEntity(string entity)
+string_view KnowledgeGraph::nameOf(uint32_t id)
 {
-    for(auto it : entities)
-    {
-        if(it == entity)
-            throw EntityExistsException("Entity already exists!");
-    }
-    entities.push_back(entity);
+    entityNode(id);
+    return symbols.name(id);
 }
 
-void KnowledgeGraph::addRelation(string from, string to, float weight)
+vector<uint32_t> KnowledgeGraph::neighbors(uint32_t id)
 {
-    if(!graph.contains(from) || !graph.contains(to))
+    KG_TIMED("KnowledgeGraph::neighbors(id)");
+    auto node = entityNode(id);
+    vector<uint32_t> result;
+    if(graph.frozen)
     {
-        throw EntityNotFoundException("Entity not found!");
+        FrozenGraph<uint32_t> *csr = graph.frozen;
+        result.assign(csr->targets.begin() + csr->offsets[id], csr->targets.begin() + csr->offsets[id + 1]);
     }
-    graph.connect(from, to, weight);
-}
-
-vector<string> KnowledgeGraph::getNeighbors(string entity)
-{
-    if(!graph.contains(entity))
-        throw EntityNotFoundException("Entity not found!");
-    return graph.getOutwardEdges(entity);
-}
-
-string KnowledgeGraph::bfs(string start)
-{
-    if(!graph.contains(start))
-        throw EntityNotFoundException("Entity not found!");
-    return graph.BFS(start);
-}
-
-string KnowledgeGraph::dfs(string start)
-{
-    if(!graph.contains(start))
-        throw EntityNotFoundException("Entity not found!");
-    return graph.DFS(start);
-}
-
-bool KnowledgeGraph::isReachable(string from, string to)
-{
-    if(!graph.contains(from) || !graph.contains(to))
-        throw EntityNotFoundException("Entity not found!");
-    return graph.connected(from, to);
-}
-
-string KnowledgeGraph::toString()
-{
-    return graph.toString();
-}
-
-vector<string> KnowledgeGraph::getRelatedEntities(string entity, int depth)
-{
-    if(!graph.contains(entity))
-        throw EntityNotFoundException("Entity not found!");
-    
-    vector<string> result;
-    vector<string> visited;
-    vector<pair<string,int>> queues; //<entity,current depth>
-    queues.push_back({entity, 0});
-    visited.push_back(entity);
-    int count = 0;
-
-    while(count < queues.size())
+    else
     {
-        pair<string,int> current = queues[count++];
-        auto current_depth = current.second;
-        auto current_entity = current.first;
-
-        if(current_depth >= depth) continue;
-        vector<string> neighbor = getNeighbors(current_entity);
-        for(auto it : neighbor)
+        result.reserve(node->adList.size());
+        for(auto edge : node->adList)
+            result.push_back(edge->to->vertex);
+    }
+    // Only a node with several labels can reach one neighbour twice
+    if(node->partitions)
+    {
+        graph.beginVisit();
+        size_t kept = 0;
+        for(auto neighbor : result)
         {
-            bool isvisited = false;
-            for(auto v : visited)
-            {
-                if(v == it)
-                {
-                    isvisited = true;
-                    break;
-                }
-            }
-            if(!isvisited)
-            {
-                visited.push_back(current_entity);
-                result.push_back(current_entity);
-                queues.push_back({current_entity, current_depth + 1});
-            }
+            if(graph.markVisited(neighbor)) result[kept++] = neighbor;
         }
+        result.resize(kept);
     }
     return result;
 }
 
-string KnowledgeGraph::findCommonAncestors(string entity1, string entity2)
+vector<uint32_t> KnowledgeGraph::bfs(uint32_t start)
 {
-    if(!graph.contains(entity1) || !graph.contains(entity2))
-        throw EntityNotFoundException("Entity not found!");
-    vector<pair<string,int>> ancestor1 = collectancestor(entity1);
-    vector<pair<string,int>> ancestor2 = collectancestor(entity2);
-    string result;
-    int mindist = 9999999;
-    bool found = false;
-
-    for(auto it_1 : ancestor1)
-    {
-        auto name_1 = it_1.first;
-        auto dist_1 = it_1.second;
-        for(auto it_2 : ancestor2)
-        {
-            auto name_2 = it_2.first;
-            auto dist_2 = it_2.second;
-
-            if(graph.checkequal(name_1, name_2))
-            {
-                found = true;
-                int total = dist_1 + dist_2;
-                if(total < mindist)
-                {
-                    mindist = total;
-                    result = name_1;
-                }
-            }
-        }
-    }
-    if(!found) return "No common ancestor";
+    KG_TIMED("KnowledgeGraph::bfs(id)");
+    vector<uint32_t> result;
+    graph.traverseBFS(entityNode(start)->vertex, [&](VertexNode<uint32_t> &node, int, VertexNode<uint32_t>*) {
+        result.push_back(node.vertex);
+        return true;
+    });
     return result;
 }
 
-vector<pair<string,int>> KnowledgeGraph::collectancestor(string &start)
+vector<uint32_t> KnowledgeGraph::dfs(uint32_t start)
 {
-    vector<string> visited;
-    vector<pair<string,int>> result;
-    vector<pair<string,int>> queues;
-    int count = 0;
-    queues.push_back({start,0});
-    visited.push_back(start);
-    while(count < queues.size())
-    {
-        pair<string,int> current = queues[count++];
-        string current_entity = current.first;
-        int current_dist = current.second;
+    KG_TIMED("KnowledgeGraph::dfs(id)");
+    vector<uint32_t> result;
+    graph.traverseDFS(entityNode(start)->vertex, [&](VertexNode<uint32_t> &node, int, VertexNode<uint32_t>*) {
+        result.push_back(node.vertex);
+        return true;
+    });
+    return result;
+}
 
-        if(current_entity != start)
-            result.push_back(current);
-        for(auto temp : this->entities)
-        {
-            if(temp == current_entity) continue;
-            if(graph.connected(temp,current_entity))
-            {
-                bool isvisited = false;
-                for(auto v : visited)
-                {
-                    if(v == temp)
-                    {
-                        isvisited = true;
-                        break;
-                    }
-                }
+bool KnowledgeGraph::isReachable(uint32_t from, uint32_t to)
+{
+    KG_TIMED("KnowledgeGraph::isReachable(id)");
+    entityNode(from);
+    entityNode(to);
+    return graph.reachable(from, to);
+}
 
-                if(!isvisited)
-                {
-                    visited.push_back(current_entity);
-                    queues.push_back({current_entity,current_dist + 1});
-                }
-            }
-        }
-    }
+vector<uint32_t> KnowledgeGraph::getRelatedEntities(uint32_t entity, int depth)
+{
+    KG_TIMED("KnowledgeGraph::getRelatedEntities(id)");
+    vector<uint32_t> result;
+    // BFS yields nodes in non-decreasing depth, so the first node past the limit ends the walk
+    graph.traverseBFS(entityNode(entity)->vertex, [&](VertexNode<uint32_t> &node, int current_depth, VertexNode<uint32_t>*) {
+        if(current_depth > depth) return false;
+        if(current_depth > 0) result.push_back(node.vertex);
+        return true;
+    });
     return result;
 }
 
@@ -611,17 +5222,67 @@ vector<pair<string,int>> KnowledgeGraph::collectancestor(string &start)
 // Explicit Template Instantiation
 // =============================================================================
 
+template class SlabPool<Edge<string>>;
+template class SlabPool<Edge<int>>;
+template class SlabPool<Edge<float>>;
+template class SlabPool<Edge<char>>;
+template class SlabPool<Edge<uint32_t>>;
+template class SlabPool<VertexNode<string>>;
+template class SlabPool<VertexNode<int>>;
+template class SlabPool<VertexNode<float>>;
+template class SlabPool<VertexNode<char>>;
+template class SlabPool<VertexNode<uint32_t>>;
+
 template class Edge<string>;
 template class Edge<int>;
 template class Edge<float>;
 template class Edge<char>;
+template class Edge<uint32_t>;
+
+template class FrozenGraph<string>;
+template class FrozenGraph<int>;
+template class FrozenGraph<float>;
+template class FrozenGraph<char>;
+template class FrozenGraph<uint32_t>;
 
 template class VertexNode<string>;
 template class VertexNode<int>;
 template class VertexNode<float>;
 template class VertexNode<char>;
+template class VertexNode<uint32_t>;
+
+template class CommonAncestorEngine<string>;
+template class CommonAncestorEngine<int>;
+template class CommonAncestorEngine<float>;
+template class CommonAncestorEngine<char>;
+template class CommonAncestorEngine<uint32_t>;
+
+template class GraphVersion<string>;
+template class GraphVersion<int>;
+template class GraphVersion<float>;
+template class GraphVersion<char>;
+template class GraphVersion<uint32_t>;
+
+template class ReadView<string>;
+template class ReadView<int>;
+template class ReadView<float>;
+template class ReadView<char>;
+template class ReadView<uint32_t>;
+
+template class CompressedGraph<string>;
+template class CompressedGraph<int>;
+template class CompressedGraph<float>;
+template class CompressedGraph<char>;
+template class CompressedGraph<uint32_t>;
+
+template class GraphSnapshot<string>;
+template class GraphSnapshot<int>;
+template class GraphSnapshot<float>;
+template class GraphSnapshot<char>;
+template class GraphSnapshot<uint32_t>;
 
 template class DGraphModel<string>;
 template class DGraphModel<int>;
 template class DGraphModel<float>;
-template class DGraphModel<char>;
\ No newline at end of file
+template class DGraphModel<char>;
+template class DGraphModel<uint32_t>;
\ No newline at end of file
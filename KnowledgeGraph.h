@@ -5,11 +5,453 @@
 
 // Forward declaration
 template <class T> class VertexNode;
-template <class T> class DGraphModel;
+template <class T> struct VertexFormat;
+template <class T, class Eq = equal_to<T>, class Hash = std::hash<T>, class Fmt = VertexFormat<T>> class DGraphModel;
+template <class T> class FrozenGraph;
+template <class U> class SlabPool;
+template <class T> class CommonAncestorEngine;
+template <class T> class GraphVersion;
+template <class T> class ReadView;
+template <class T> class CompressedGraph;
+class KnowledgeGraph;
+
+// =====================================
+// Class SlabPool
+// =====================================
+// Hands out uninitialised storage for U objects carved from fixed-size slabs.
+// Recycled slots are kept on an intrusive free list; release() drops every
+// slab at once without visiting the objects, so callers must run any
+// non-trivial destructors themselves before releasing.
+template <class U>
+class SlabPool {
+private:
+    vector<U*> slabs;
+    size_t slabSize;
+    size_t used;        // slots handed out from the last slab
+    void* freeList;
+
+public:
+    SlabPool(size_t slabSize = 1024);
+    ~SlabPool();
+
+    void* allocate();
+    void recycle(U* obj);
+    void release();
+    size_t bytes();     // slab storage, free slots included
+    void swap(SlabPool<U> &other);
+};
+
+// =====================================
+// Class WorkerPool
+// =====================================
+// Fixed set of threads that run the same task in lock step. run(task) calls
+// task(worker) on every worker (the calling thread is worker 0) and returns
+// once all of them have finished, so it can be issued once per BFS level.
+// run(task, count) only uses workers 0 .. count - 1, so a pool sized for the
+// largest request serves smaller ones too. An exception thrown by a task is
+// rethrown from run() once every worker has finished.
+class WorkerPool {
+private:
+    vector<thread> workers;
+    mutex lock;
+    condition_variable wake;
+    condition_variable done;
+    function<void(int)> task;
+    unsigned long generation;
+    int pending;
+    int active;
+    bool stopping;
+    exception_ptr failure;      // first exception a worker threw during the current run
+
+    void workerLoop(int worker);
+
+public:
+    WorkerPool(int threads);
+    ~WorkerPool();
+
+    int size();
+    void run(function<void(int)> task, int count = INT_MAX);
+};
+
+// =====================================
+// Class EpochDomain
+// =====================================
+// Epoch-based reclamation for data read without locks. A reader pins the
+// current epoch while it holds pointers into shared data; the single writer
+// retires whatever it unpublishes, tagged with a fresh epoch, and frees it once
+// every pinned reader has moved past that tag. Reader slots sit on their own
+// cache lines so readers never write to shared lines. There is one slot per
+// pinned reader; when all are taken pin() links another block of them, and
+// blocks stay until the domain goes away.
+class EpochDomain {
+private:
+    static const int BLOCK_READERS = 64;
+    static const uint64_t IDLE = UINT64_MAX;
+    struct alignas(64) ReaderSlot {
+        atomic<bool> taken;
+        atomic<uint64_t> epoch;
+    };
+    struct SlotBlock {
+        ReaderSlot slots[BLOCK_READERS];
+        atomic<SlotBlock*> next;
+
+        SlotBlock();
+    };
+    SlotBlock head;
+    atomic<uint64_t> globalEpoch;
+    vector<pair<uint64_t, function<void()>>> retired;  // writer side only
+
+public:
+    EpochDomain();
+    ~EpochDomain();
+
+    int pin();
+    void unpin(int slot);
+    void retire(function<void()> reclaim);
+    void reclaim();
+    size_t pending();
+};
+
+// =====================================
+// Class LatencyHistogram
+// =====================================
+// HdrHistogram-style log-linear buckets over nanoseconds: values below 16 are
+// exact, every power of two above that is split into 16 buckets, so reported
+// percentiles are within ~6% of the true value. All updates are relaxed atomics.
+class LatencyHistogram {
+private:
+    static const int SUB_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+    atomic<uint64_t> counts[BUCKETS];
+    atomic<uint64_t> total;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> minimum;
+    atomic<uint64_t> maximum;
+
+    static int bucketOf(uint64_t value);
+    static uint64_t bucketValue(int bucket);     // highest value that lands in the bucket
+
+public:
+    LatencyHistogram();
+
+    void record(uint64_t nanos);
+    uint64_t count();
+    uint64_t min();
+    uint64_t max();
+    double mean();
+    uint64_t percentile(double p);
+    void reset();
+};
+
+// =====================================
+// Class Metrics
+// =====================================
+enum MetricCounter {
+    METRIC_LOOKUPS,             // vertex / symbol lookups by value
+    METRIC_EDGES_SCANNED,
+    METRIC_VERTICES_VISITED,
+    METRIC_ALLOCATIONS,         // vertices and edges created
+    METRIC_COUNTERS
+};
+
+struct OperationStats {
+    string name;
+    uint64_t count;
+    double meanNs;
+    uint64_t minNs;
+    uint64_t p50Ns;
+    uint64_t p90Ns;
+    uint64_t p99Ns;
+    uint64_t p999Ns;
+    uint64_t maxNs;
+};
+
+struct MetricsSnapshot {
+    uint64_t counters[METRIC_COUNTERS];
+    vector<OperationStats> operations;      // in order of first use, idle ones left out
+
+    string toText();
+    string toJSON();
+};
+
+// Process-wide counters and per-operation latency histograms. Instrumentation
+// goes through KG_TIMED / KG_COUNT, which expand to nothing unless the build
+// defines KG_ENABLE_METRICS; the API below is always there and reads zeros then.
+class Metrics {
+private:
+    atomic<uint64_t> counters[METRIC_COUNTERS];
+    mutex registryLock;
+    vector<pair<string, LatencyHistogram*>> histograms;    // never freed, call sites cache them
+
+    Metrics();
+
+public:
+    static Metrics& instance();
+    static bool enabled();
+    static const char* counterName(MetricCounter counter);
+
+    void count(MetricCounter counter, uint64_t amount)
+    {
+        counters[counter].fetch_add(amount, memory_order_relaxed);
+    }
+    LatencyHistogram* histogram(const char *operation);
+    MetricsSnapshot snapshot();
+    void reset();
+    string toText();
+    string toJSON();
+};
+
+// Times the enclosing scope into a histogram
+class ScopedLatency {
+private:
+    LatencyHistogram *histogram;
+    chrono::steady_clock::time_point begin;
+
+public:
+    ScopedLatency(LatencyHistogram *histogram) : histogram(histogram), begin(chrono::steady_clock::now()) {}
+    ~ScopedLatency()
+    {
+        histogram->record(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count());
+    }
+};
+
+#ifdef KG_ENABLE_METRICS
+#define KG_METRIC_CAT_(a, b) a##b
+#define KG_METRIC_CAT(a, b) KG_METRIC_CAT_(a, b)
+#define KG_TIMED(operation) \
+    static LatencyHistogram *KG_METRIC_CAT(kgHistogram_, __LINE__) = Metrics::instance().histogram(operation); \
+    ScopedLatency KG_METRIC_CAT(kgLatency_, __LINE__)(KG_METRIC_CAT(kgHistogram_, __LINE__))
+#define KG_COUNT(counter, amount) Metrics::instance().count(counter, amount)
+#else
+#define KG_TIMED(operation) ((void)0)
+#define KG_COUNT(counter, amount) ((void)0)
+#endif
+
+// =====================================
+// Class ReachabilityIndex
+// =====================================
+// Transitive reachability over dense vertex ids. build() condenses strongly
+// connected components and labels the resulting DAG with:
+//  - a longest-path level (an edge always climbs at least one level),
+//  - several post-order intervals; v reachable from u implies v's interval nests in u's,
+//  - a spanning-tree interval; nesting there proves reachability.
+// Queries the labels cannot settle fall back to a pruned bidirectional BFS on the DAG.
+class ReachabilityIndex {
+private:
+    int vertexCount;
+    vector<int> comp;           // vertex -> component
+    vector<int> dagOffsets;     // component DAG in CSR form, both directions
+    vector<int> dagTargets;
+    vector<int> rdagOffsets;
+    vector<int> rdagTargets;
+    vector<int> level;
+    static const int LABEL_PASSES = 4;
+    vector<int> low[LABEL_PASSES];
+    vector<int> post[LABEL_PASSES];
+    vector<int> pre;
+    vector<int> treeEnd;
+    bool valid;
+
+    vector<unsigned int> forwardMark;
+    vector<unsigned int> backwardMark;
+    unsigned int searchEpoch;
+
+    void condense(const vector<int> &offsets, const vector<int> &targets);
+    void label(int pass);
+    bool mayReach(int from, int to);
+    bool search(int from, int to);
+
+public:
+    ReachabilityIndex();
+
+    void build(int vertices, const vector<int> &offsets, const vector<int> &targets);
+    bool reachable(int from, int to);
+    bool isValid();
+    void invalidate();
+    int components();
+    size_t bytes();
+};
+
+// =====================================
+// Class SymbolTable
+// =====================================
+// Interns names to dense ids 0, 1, 2, ... in insertion order. Names are stored
+// back to back in a single arena and indexed by an open-addressing table of
+// ids, so a name costs its bytes plus a few words. Views returned by name()
+// stay valid until the next intern().
+class SymbolTable {
+private:
+    vector<char> arena;
+    vector<uint64_t> offsets;   // name i is arena[offsets[i], offsets[i] + lengths[i])
+    vector<uint32_t> lengths;
+    vector<uint64_t> slots;     // (hash >> 32) << 32 | (id + 1), 0 = empty
+    size_t deadBytes;           // arena bytes of removed names, repacked by truncate()
+
+    static uint64_t hashName(string_view name);
+    void rehash(size_t slotCount);
+    size_t slotOf(uint32_t id);
+
+public:
+    static const uint32_t npos = UINT32_MAX;
+
+    SymbolTable();
+
+    uint32_t find(string_view name);
+    uint32_t intern(string_view name);
+    string_view name(uint32_t id);
+    uint32_t size();
+    void reserve(size_t count, size_t bytes = 0);
+    void clear();
+    size_t arenaBytes();
+    size_t indexBytes();    // offsets, lengths and hash slots
+    void shrinkToFit();
+
+    // Removal keeps the id's bytes until truncate() drops it; find() stops
+    // returning it at once. swap() exchanges the names behind two ids.
+    void remove(uint32_t id);
+    void swap(uint32_t a, uint32_t b);
+    void truncate(uint32_t count);
+};
+
+// =====================================
+// Class DaryHeap
+// =====================================
+// 4-ary min-heap of (key, id) pairs. Children of slot i sit in 4i+1 .. 4i+4, so
+// a sift-down compares one cache line of siblings per level. There is no
+// decrease-key: callers push again and skip stale entries when popping.
+class DaryHeap {
+private:
+    static const int ARITY = 4;
+    vector<pair<float,int>> items;
+
+public:
+    void push(float key, int id);
+    pair<float,int> pop();
+    bool empty();
+    void clear();
+    size_t bytes();
+};
+
+// =====================================
+// Struct PathResult
+// =====================================
+template <class T>
+struct PathResult {
+    bool found;
+    float distance;
+    vector<T> path;     // from .. to, empty when not found
+};
+
+// =====================================
+// Struct SnapshotHeader
+// =====================================
+// On-disk layout written by DGraphModel::save. Every section starts on an
+// 8-byte boundary at the offset recorded in the header:
+//   VALUES     string graphs: uint64 offsets[V+1] into STRINGS; otherwise T[V]
+//   STRINGS    concatenated vertex names (string graphs only)
+//   OFFSETS    int32[V+1], TARGETS int32[E], WEIGHTS float[E],
+//              LABELS uint32[E]                                 (out-edge CSR)
+//   IN_OFFSETS int32[V+1], SOURCES int32[E]                     (in-edge CSR)
+//   HASH       int32[hashSlots], open-addressing table of vertex ids, -1 = empty
+//   LABEL_OFFSETS uint64[labelCount+1] into LABEL_STRINGS, the names of labels
+//              1 .. labelCount; both empty when the writer had no names
+enum SnapshotSection {
+    SNAP_VALUES, SNAP_STRINGS, SNAP_OFFSETS, SNAP_TARGETS, SNAP_WEIGHTS, SNAP_LABELS,
+    SNAP_IN_OFFSETS, SNAP_SOURCES, SNAP_HASH, SNAP_LABEL_OFFSETS, SNAP_LABEL_STRINGS,
+    SNAPSHOT_SECTIONS
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t valueType;
+    uint64_t vertexCount;
+    uint64_t edgeCount;
+    uint64_t hashSlots;
+    uint64_t labelCount;
+    uint64_t section[SNAPSHOT_SECTIONS];
+    uint64_t fileSize;
+    uint64_t checksum;      // FNV-1a of bytes [sizeof(SnapshotHeader), fileSize)
+};
+
+// =====================================
+// Class GraphSnapshot
+// =====================================
+// Read-only view of a snapshot file mapped with mmap. Nothing is copied on
+// open, pages are faulted in as queries touch them. Opening only checks the
+// header: every section must fit inside the file. The contents (CSR offsets,
+// vertex ids, string offsets, hash table) are trusted unless validate() is run,
+// one O(V+E) pass, and the checksum unless verify() is run; the constructor
+// runs either when asked, and DGraphModel/KnowledgeGraph::load run both. Open
+// files you did not write yourself with validateContents.
+template <class T>
+class GraphSnapshot {
+    #ifdef TESTING
+        friend class TestHelper;
+    #endif
+private:
+    void* mapping;
+    size_t mappedSize;
+    const SnapshotHeader* header;
+    const uint64_t* stringOffsets;
+    const char* strings;
+    const T* podValues;
+    const int32_t* offsets;
+    const int32_t* targets;
+    const float* weights;
+    const uint32_t* labels;
+    const int32_t* inOffsets;
+    const int32_t* sources;
+    const int32_t* hashTable;
+    const uint64_t* labelOffsets;
+    const char* labelStrings;
+
+    vector<unsigned int> visitMark;
+    unsigned int visitEpoch;
+
+    string (*vertex2str)(T&);
+
+    int find(T &vertex);
+    bool valueEquals(int id, T &vertex);
+    string vertex2Str(int id);
+
+public:
+    GraphSnapshot(string path, string (*vertex2str)(T&) = nullptr, bool verifyChecksum = false,
+                  bool validateContents = false);
+    ~GraphSnapshot();
+
+    bool verify();
+    bool validate();
+    int size();
+    int edgeCount();
+    T getVertex(int id);
+
+    bool contains(T vertex);
+    float weight(T from, T to);
+    uint32_t label(T from, T to);
+    // Names stored for labels 1 .. labelCount()
+    uint32_t labelCount();
+    string_view labelName(uint32_t label);
+    bool connected(T from, T to);
+    vector<T> getOutwardEdges(T from);
+    vector<T> getInwardEdges(T to);
+    int inDegree(T vertex);
+    int outDegree(T vertex);
+    vector<T> vertices();
+    string BFS(T start);
+    string DFS(T start);
+
+    template <class U, class E, class H, class F> friend class DGraphModel;
+    friend class KnowledgeGraph;
+};
 
 // =====================================
 // Class Edge
 // =====================================
+// Label filter that matches every edge, whatever its label
+const uint32_t ANY_LABEL = UINT32_MAX;
+
 template <class T>
 class Edge {
     #ifdef TESTING
@@ -19,69 +461,494 @@ private:
     VertexNode<T>* from;
     VertexNode<T>* to;
     float weight;
+    uint32_t label;     // relation type, 0 = unlabeled
 
 public:
-    Edge(VertexNode<T>* from = nullptr, VertexNode<T>* to = nullptr, float weight = 0);
+    Edge(VertexNode<T>* from = nullptr, VertexNode<T>* to = nullptr, float weight = 0, uint32_t label = 0);
     
     bool equals(Edge<T>* edge);
     static bool edgeEQ(Edge<T>*& edge1, Edge<T>*& edge2);
     string toString();
 
     friend class VertexNode<T>;
-    friend class DGraphModel<T>;
+    template <class U, class E, class H, class F> friend class DGraphModel;
+    template <class V> friend class FrozenGraph;
+    template <class V> friend class CompressedGraph;
+    friend class CommonAncestorEngine<T>;
+    friend class KnowledgeGraph;
 };
 
 // =====================================
 // Class VertexNode
 // =====================================
+// Out-edges always live in adList, which fixes the traversal order. A node
+// holds at most one edge per (target, label). Once a node's out-degree reaches
+// INDEX_DEGREE it also gets edgeIndex, a hash multimap from target node to its
+// edges, so getEdge and connected() on a hub cost O(1) on average. removeTo
+// only finds the edge through the index: adList and the target's inList keep
+// insertion order, so taking it out of them stays O(out-degree + target
+// in-degree). The index is dropped again when the degree falls below a quarter
+// of INDEX_DEGREE.
+// While all of a node's out-edges share one label, and all of its in-edges
+// another, adList and inList serve label-filtered walks as they are; the first
+// edge with a second label gives the node partitions that group its edges by
+// label in insertion order.
+// A removed node keeps its slot, with no edges, until the graph is compacted.
 template <class T>
 class VertexNode {
     #ifdef TESTING
         friend class TestHelper;
     #endif
 private:
+    typedef vector<pair<uint32_t, vector<Edge<T>*>>> LabelGroups;
+    struct LabelPartitions {
+        LabelGroups out;
+        LabelGroups in;
+    };
+
     T vertex;
+    int id;         // dense index of this node inside its DGraphModel
     int inDegree_;
     int outDegree_;
     vector<Edge<T>*> adList; 
-    
-    // Function pointers
-    bool (*vertexEQ)(T&, T&);
-    string (*vertex2str)(T&);
+    vector<Edge<T>*> inList;    // edges pointing to this node, owned by the source's adList
+    SlabPool<Edge<T>>* edgePool; // where connect() takes edges from, nullptr for plain new/delete
+    unordered_multimap<VertexNode<T>*, Edge<T>*>* edgeIndex; // target -> edges on high-degree nodes, else nullptr
+    LabelPartitions* partitions;    // nullptr while each direction has a single label
+    bool removed;
+
+    void buildIndex();
+    void partition();
+    static void group(LabelGroups &groups, Edge<T>* edge);
+    static void ungroup(LabelGroups &groups, Edge<T>* edge);
+    static vector<Edge<T>*>* labelled(LabelGroups &groups, uint32_t label);
+    void unlink(Edge<T>* edge);     // from adList, the source side
+    void unlinkIn(Edge<T>* edge);   // from inList, the target side
 
 public:
-    VertexNode(T vertex, bool (*vertexEQ)(T&, T&) = nullptr, string (*vertex2str)(T&) = nullptr);
+    static const int INDEX_DEGREE = 32;
+
+    VertexNode(T vertex);
+    ~VertexNode();
+    VertexNode(const VertexNode<T>&) = delete;
+    VertexNode<T>& operator=(const VertexNode<T>&) = delete;
     
     T& getVertex();
-    void connect(VertexNode<T>* to, float weight = 0);
-    Edge<T>* getEdge(VertexNode<T>* to);
+    void connect(VertexNode<T>* to, float weight = 0, uint32_t label = 0);
+    // The edge with that label, or with ANY_LABEL the first edge to the target in adList order
+    Edge<T>* getEdge(VertexNode<T>* to, uint32_t label = ANY_LABEL);
+    // Out- or in-edges with the given label in insertion order, nullptr when
+    // there are none; ANY_LABEL gives adList or inList
+    vector<Edge<T>*>* outEdges(uint32_t label);
+    vector<Edge<T>*>* inEdges(uint32_t label);
     bool equals(VertexNode<T>* node);
-    void removeTo(VertexNode<T>* to);
+    // Drops the edge with that label, or with ANY_LABEL every edge to the target
+    void removeTo(VertexNode<T>* to, uint32_t label = ANY_LABEL);
     int inDegree();
     int outDegree();
     string toString();
 
     friend class Edge<T>;
-    friend class DGraphModel<T>;
+    template <class U, class E, class H, class F> friend class DGraphModel;
+    template <class V> friend class FrozenGraph;
+    template <class V> friend class CompressedGraph;
+    friend class CommonAncestorEngine<T>;
+    friend class KnowledgeGraph;
 };
 
 // =====================================
-// Class DGraphModel
+// Class FrozenGraph
+// =====================================
+// Immutable compressed-sparse-row copy of a DGraphModel. Vertex i of the
+// snapshot is the node with id i; its out-edges are
+// targets/weights/labels[offsets[i] .. offsets[i+1]) in adList order and its
+// in-edges are sources[inOffsets[i] .. inOffsets[i+1]).
+template <class T>
+class FrozenGraph {
+    #ifdef TESTING
+        friend class TestHelper;
+    #endif
+private:
+    vector<T> values;
+    vector<int> offsets;
+    vector<int> targets;
+    vector<float> weights;
+    vector<uint32_t> labels;
+    vector<int> inOffsets;
+    vector<int> sources;
+
+public:
+    FrozenGraph(vector<VertexNode<T>*> &nodeList);
+    // Same layout, with values[i] = valueOf(nodeList[i]->vertex)
+    template <class U, class F>
+    FrozenGraph(vector<VertexNode<U>*> &nodeList, F valueOf);
+
+    int size();
+    int edgeCount();
+    size_t bytes();
+    T& getVertex(int id);
+    int findEdge(int from, int to, uint32_t label = ANY_LABEL);
+    // Writes the snapshot file read by GraphSnapshot, storing values[i] for vertex i
+    // and labelNames[i] as the name of label i + 1
+    template <class V>
+    void write(string path, vector<V> &values, const vector<string_view> &labelNames = vector<string_view>());
+
+    template <class U, class E, class H, class F> friend class DGraphModel;
+    friend class CommonAncestorEngine<T>;
+    friend class GraphVersion<T>;
+    friend class ReadView<T>;
+    friend class KnowledgeGraph;
+};
+
+// =====================================
+// Class GraphVersion
+// =====================================
+// One published, immutable state of a graph: a CSR copy plus a value index.
+// Readers reach it through a ReadView; the writer retires it to an EpochDomain
+// when a newer version replaces it.
+template <class T>
+class GraphVersion {
+    #ifdef TESTING
+        friend class TestHelper;
+    #endif
+private:
+    FrozenGraph<T> csr;
+    unordered_multimap<size_t, int> index;  // hash -> id, only used when vertexHash is set
+    uint64_t number;
+
+    // Copies of the publishing graph's comparison, formatting and hashing
+    function<bool(T&, T&)> vertexEQ;
+    function<string(T&)> vertex2str;
+    function<size_t(T&)> vertexHash;
+    // Copy of a KnowledgeGraph's label names, empty for a DGraphModel
+    SymbolTable labels;
+
+    int find(T &vertex);
+
+public:
+    template <class U, class F>
+    GraphVersion(vector<VertexNode<U>*> &nodeList, F valueOf, uint64_t number,
+                 function<bool(T&, T&)> vertexEQ, function<string(T&)> vertex2str, function<size_t(T&)> vertexHash,
+                 const SymbolTable &labels = SymbolTable());
+    size_t bytes();
+
+    friend class ReadView<T>;
+};
+
+// =====================================
+// Class ReadView
+// =====================================
+// A reader's handle on the version that was current when the view was taken.
+// The view pins an epoch, so that version stays alive until the view goes away,
+// whatever the writer publishes meanwhile. Views are cheap; take one per query
+// batch and do not share one between threads. A view must not outlive the
+// graph it came from: the graph's destructor frees every version, pinned or not.
+template <class T>
+class ReadView {
+    #ifdef TESTING
+        friend class TestHelper;
+    #endif
+private:
+    EpochDomain *domain;
+    int slot;
+    GraphVersion<T> *version;   // nullptr before the first publish
+    vector<unsigned int> visitMark;
+    unsigned int visitEpoch;
+
+    int find(T &vertex);
+    int require(T &vertex);
+    void beginVisit();
+    string vertex2Str(int id);
+
+public:
+    ReadView(EpochDomain *domain, atomic<GraphVersion<T>*> &published);
+    ReadView(ReadView<T> &&other);
+    ReadView(const ReadView<T> &) = delete;
+    ReadView<T>& operator=(const ReadView<T> &) = delete;
+    ~ReadView();
+
+    uint64_t versionNumber();   // 0 before the first publish
+    int size();
+    int edgeCount();
+    bool contains(T vertex);
+    vector<T> vertices();
+    float weight(T from, T to);
+    uint32_t label(T from, T to);
+    // Resolves a KnowledgeGraph relation label, "" being 0; false for an unknown name
+    bool findLabel(string_view name, uint32_t &label);
+    bool connected(T from, T to);
+    // The label filtered walks follow only edges with that label
+    vector<T> getOutwardEdges(T from, uint32_t label = ANY_LABEL);
+    vector<T> getInwardEdges(T to);
+    int inDegree(T vertex);
+    int outDegree(T vertex);
+    string BFS(T start, uint32_t label = ANY_LABEL);
+    string DFS(T start, uint32_t label = ANY_LABEL);
+    // Vertices 1..depth hops from start, in BFS order
+    vector<T> related(T start, int depth, uint32_t label = ANY_LABEL);
+};
+
 // =====================================
+// Class CompressedGraph
+// =====================================
+// Read-only adjacency in a few bytes per edge. Each vertex's out-neighbours are
+// sorted by id and stored as LEB128 varints, the first id as is and every later
+// one as the gap to its predecessor minus one; a list ends where the next one
+// starts, and its length is the number of bytes without the continuation bit.
+// Weights cost nothing when every edge has the same one, otherwise they are
+// (weight, run length) pairs in neighbour order. In-edges get the same encoding
+// only when asked for; without them inDegree and getInwardEdges scan every list.
+// Traversals decode on the fly and visit neighbours in id order (vertex
+// insertion order), not in the order the edges were added. Edge labels are
+// not kept, so there are no label filtered queries, and edges under several
+// labels between one pair become a single edge with the first one's weight.
 template <class T>
+class CompressedGraph {
+    #ifdef TESTING
+        friend class TestHelper;
+    #endif
+private:
+    // Concatenated varint lists; list i starts at bytes[base[i / BLOCK] + offsets[i]]
+    struct VarintLists {
+        static const int BLOCK = 4096;
+        vector<uint8_t> bytes;
+        vector<uint64_t> base;
+        vector<uint32_t> offsets;   // one more than there are lists
+
+        void append(vector<int> &sorted);
+        void close();
+        const uint8_t* begin(int list);
+        const uint8_t* end(int list);
+        size_t memory();
+    };
+
+    vector<T> values;
+    VarintLists targets;
+    VarintLists sources;        // empty unless built with in-edges
+    bool inEdges;
+    size_t edges;
+    float uniformWeight;        // every edge's weight while weightOffsets is empty
+    vector<uint64_t> weightOffsets;
+    vector<uint8_t> weightRuns; // per vertex: (float, varint run length) pairs
+
+    unordered_multimap<size_t, int> index;  // hash -> id, only used when vertexHash is set
+    function<bool(T&, T&)> vertexEQ;
+    function<string(T&)> vertex2str;
+    function<size_t(T&)> vertexHash;
+
+    vector<unsigned int> visitMark;
+    unsigned int visitEpoch;
+
+    static void putVarint(vector<uint8_t> &out, uint64_t value);
+    static uint64_t getVarint(const uint8_t *&p);
+
+    // Encodes one vertex's out-edges, which must be sorted by target and distinct
+    void appendRow(vector<pair<int, float>> &row, vector<int> &scratch);
+    void finish();
+    int find(T &vertex);
+    int require(T &vertex);
+    int rank(int from, int to);
+    float weightAt(int from, int k);
+    void beginVisit();
+    string vertex2Str(int id);
+
+public:
+    template <class U, class F>
+    CompressedGraph(vector<VertexNode<U>*> &nodeList, F valueOf, bool inEdges,
+                    function<bool(T&, T&)> vertexEQ, function<string(T&)> vertex2str, function<size_t(T&)> vertexHash);
+    // Builds straight from an edge list over ids 0 .. values.size() - 1, without
+    // going through a DGraphModel. Repeated edges keep their first weight, the
+    // weight is 0 when weights is nullptr.
+    CompressedGraph(vector<T> values, vector<pair<int,int>> &edges, vector<float> *weights = nullptr, bool inEdges = false);
+
+    int size();
+    int edgeCount();
+    // Bytes held by the adjacency lists, their offsets and the weights
+    size_t adjacencyBytes();
+    T getVertex(int id);
+
+    bool contains(T vertex);
+    float weight(T from, T to);
+    bool connected(T from, T to);
+    vector<T> getOutwardEdges(T from);
+    vector<T> getInwardEdges(T to);
+    int inDegree(T vertex);
+    int outDegree(T vertex);
+    vector<T> vertices();
+    string BFS(T start);
+    string DFS(T start);
+};
+
+// =====================================
+// Answers "nearest common ancestor of a and b": among the vertices with a path
+// to both a and b (other than a and b themselves), the one minimising the sum
+// of the two distances, ties going to the one met first by a reverse BFS from a.
+// Without an index both reverse BFS run interleaved and stop as soon as no
+// undiscovered vertex can beat the best candidate. For forests (every vertex
+// has at most one parent) buildIndex() adds depth and jump pointers that answer
+// in O(log n) until the next edge change.
+template <class T>
+class CommonAncestorEngine {
+private:
+    vector<VertexNode<T>*> &nodeList;   // the owning graph's, read on every query
+    FrozenGraph<T>* &frozen;
+
+    vector<unsigned int> mark[2];
+    vector<int> dist[2];
+    vector<int> order;          // discovery rank of the reverse BFS from a
+    vector<int> onlyCount[2];   // onlyCount[s][d]: vertices at distance d seen from side s only
+    vector<int> frontier[2];
+    vector<int> next;
+    unsigned int epoch;
+
+    vector<int> parent;
+    vector<int> depth;
+    vector<int> jump;
+    int indexedSize;
+    bool indexed;
+
+    int search(int a, int b, uint32_t label);
+    int indexedLCA(int a, int b);
+
+public:
+    CommonAncestorEngine(vector<VertexNode<T>*> &nodeList, FrozenGraph<T>* &frozen);
+
+    // Vertex id, or -1 when there is none. With a label only edges carrying it
+    // count, which always takes the search since the index covers every edge.
+    int nearest(int a, int b, uint32_t label = ANY_LABEL);
+    bool buildIndex();
+    bool hasIndex();
+    void invalidate();
+    size_t bytes();
+};
+
+// =====================================
+// Struct VertexFormat
+// =====================================
+// Default formatting policy: whatever operator<< prints
+template <class T>
+struct VertexFormat {
+    string operator()(T &vertex) const
+    {
+        stringstream ss;
+        ss << vertex;
+        return ss.str();
+    }
+};
+
+// =====================================
+// Struct MemoryUsage
+// =====================================
+// Heap bytes by category. Vector buffers count at capacity, hash tables by
+// buckets plus nodes; what the allocator adds per block is not counted.
+struct MemoryUsage {
+    size_t vertexObjects;   // VertexNode objects (whole pool slabs when pooled) and nodeList
+    size_t edgeObjects;     // Edge objects (whole pool slabs when pooled)
+    size_t adjacency;       // adList/inList entries in use
+    size_t adjacencySlack;  // capacity beyond size in adList, inList and nodeList
+    size_t strings;         // string payloads on the heap, symbol arena included
+    size_t indexes;         // vertex lookup, symbol slots, hub edge indexes and label partitions
+    size_t derived;         // frozen CSR, reachability/ancestor indexes, published version, scratch
+
+    size_t total();
+    MemoryUsage& operator+=(const MemoryUsage &other);
+    string toText();
+    string toJSON();
+};
+
+// =====================================
+// Enum VertexLayout
+// =====================================
+// Orders DGraphModel::reorder() can lay vertex storage out in
+enum VertexLayout {
+    LAYOUT_BFS,         // breadth-first along out-edges, components taken in id order
+    LAYOUT_RCM,         // reverse Cuthill-McKee over the edges taken both ways
+    LAYOUT_DEGREE       // total degree, highest first, so the hubs sit together
+};
+
+// =====================================
+// Class DGraphModel
+// =====================================
+// Eq, Hash and Fmt are stateless policy functors, default-constructed and
+// inlined into lookups. Function pointers passed to the constructor still take
+// precedence, so existing callers keep their behaviour; a vertexEQ given without
+// a vertexHash means values cannot be hashed and lookups scan linearly. Each
+// policy combination needs an explicit instantiation in KnowledgeGraph.cpp.
+template <class T, class Eq, class Hash, class Fmt>
 class DGraphModel {
     #ifdef TESTING
         friend class TestHelper;
     #endif
 private:
     vector<VertexNode<T>*> nodeList;
+    bool pooled;                        // nodes and edges live in the pools below
+    SlabPool<VertexNode<T>> nodePool;
+    SlabPool<Edge<T>> edgePool;
+    unordered_multimap<size_t, VertexNode<T>*> nodeIndex; // hash -> node, unused when lookups scan
+
+    // Removed nodes keep their slot until compact(); a pass in progress has
+    // moved the live nodes before compactRead down to [0, compactWrite)
+    int tombstones;
+    size_t compactRead;
+    size_t compactWrite;
+    // Called with (a, b) once compaction has swapped the nodes at ids a and b;
+    // it may rewrite their vertices, the index is refreshed afterwards
+    function<void(int, int)> renumbered;
+
+    // Visited marks for traversals: a node is visited iff visitMark[node->id] == visitEpoch
+    vector<unsigned int> visitMark;
+    unsigned int visitEpoch;
+    struct TraversalItem {
+        int id;
+        int parent;     // id of the node that discovered this one, -1 for the start
+        int depth;
+    };
+    vector<TraversalItem> traversalBuf;
+
+    FrozenGraph<T>* frozen;     // CSR snapshot, dropped by any mutation
+    WorkerPool* pool;           // kept for the parallel queries, grown to the most threads asked for
+    EpochDomain epochs;
+    atomic<GraphVersion<T>*> published;    // what ReadViews see, replaced by publish()
+    uint64_t versions;
+    ReachabilityIndex reach;    // rebuilt lazily once a mutation invalidates it
+    CommonAncestorEngine<T> ancestors;
+
+    // Dijkstra scratch, valid for ids marked in the current visit epoch
+    vector<float> pathDist;
+    vector<int> pathParent;
+    DaryHeap pathHeap;
+    void dijkstra(int source, int target);
+    vector<float> deltaStepping(int source, int threads);
+
+    WorkerPool& workerPool(int threads);
+    vector<vector<int>> levelIds(int start, int threads, int maxDepth);
+    vector<vector<int>> parallelLevelIds(int start, int threads, int maxDepth);
+
+    VertexNode<T>* createNode(T &vertex);
+    void destroyNode(VertexNode<T>* node);
+    void unindex(VertexNode<T>* node);
+    vector<int> layoutOrder(VertexLayout layout);   // live ids in layout order
+    // Rebuilds edges from a snapshot whose vertex ids match nodeList
+    template <class V>
+    void restoreEdges(GraphSnapshot<V> &snapshot);
     
-    // Function pointers
+    Eq eq;
+    Hash hasher;
+    Fmt fmt;
+    bool hashed;
+
+    // Function pointers, override the policies when set
     bool (*vertexEQ)(T&, T&);
     string (*vertex2str)(T&);
+    size_t (*vertexHash)(T&);
+
+    size_t hashOf(T &vertex);
+    // Copies of the policies, for compress() results, which may outlive the graph,
+    // and published versions, which must not
+    void copyPolicies(function<bool(T&, T&)> &equal, function<string(T&)> &format, function<size_t(T&)> &hash);
 
 public:
-    DGraphModel(bool (*vertexEQ)(T&, T&) = nullptr, string (*vertex2str)(T&) = nullptr);
+    DGraphModel(bool (*vertexEQ)(T&, T&) = nullptr, string (*vertex2str)(T&) = nullptr, size_t (*vertexHash)(T&) = nullptr, bool pooled = true);
     ~DGraphModel();
 
     VertexNode<T>* getVertexNode(T& vertex);
@@ -90,13 +957,34 @@ public:
     bool checkequal(T &node1, T &node2);
 
     void add(T vertex);
+    // Detaches every in- and out-edge and leaves a tombstone in the vertex's
+    // slot; size() and vertices() skip it at once
+    void remove(T vertex);
+    // Reclaims tombstoned slots, renumbering the survivors in insertion order.
+    // Each call moves at most budget slots and returns true once none are left,
+    // so a large graph can be compacted in short steps between queries.
+    bool compact(int budget = INT_MAX);
+    // Moves the vertex and edge objects and the adjacency buffers into fresh
+    // storage, allocated vertex by vertex in the given order, so walks that
+    // roughly follow it read neighbouring memory. Ids and the order of every
+    // adjacency list are kept, so vertices(), BFS, DFS and every other result
+    // come out the same; only pointers to nodes and edges change.
+    void reorder(VertexLayout layout = LAYOUT_BFS);
+    void reserve(int capacity);
     bool contains(T vertex);
-    float weight(T from, T to);
-    vector<T> getOutwardEdges(T from);
+    // With ANY_LABEL these read the first edge from -> to in insertion order
+    float weight(T from, T to, uint32_t label = ANY_LABEL);
+    uint32_t label(T from, T to);
+    vector<T> getOutwardEdges(T from, uint32_t label = ANY_LABEL);
+    vector<T> getInwardEdges(T to, uint32_t label = ANY_LABEL);
     
-    void connect(T from, T to, float weight = 0);
-    void disconnect(T from, T to);
-    bool connected(T from, T to);
+    // A pair of vertices holds at most one edge per label: connecting it again
+    // under the same label leaves the existing edge as it is
+    void connect(T from, T to, float weight = 0, uint32_t label = 0);
+    // Removes the edge with that label, or with ANY_LABEL every edge from -> to.
+    // Linear in from's out-degree and to's in-degree, see VertexNode
+    void disconnect(T from, T to, uint32_t label = ANY_LABEL);
+    bool connected(T from, T to, uint32_t label = ANY_LABEL);
 
     int size();
     bool empty();
@@ -109,6 +997,95 @@ public:
     string toString();
     string BFS(T start);
     string DFS(T start);
+
+    // Visitor receives (node, depth, parent or nullptr) and returns false to stop the walk.
+    // It must not start another traversal on the same graph. A label restricts
+    // the walk to edges carrying it.
+    typedef function<bool(VertexNode<T>&, int, VertexNode<T>*)> Visitor;
+    void traverseBFS(T start, Visitor visit, uint32_t label = ANY_LABEL);
+    void traverseDFS(T start, Visitor visit, uint32_t label = ANY_LABEL);
+
+    // Level-synchronous BFS; level i holds the vertices at distance i, in insertion order.
+    // With threads > 1 the frontier is expanded in parallel over the frozen CSR
+    // (freezing the graph if needed), switching between top-down and bottom-up steps.
+    // A negative maxDepth yields no levels, as getRelatedEntities yields nothing.
+    vector<vector<T>> BFSLevels(T start, int threads = 1, int maxDepth = INT_MAX);
+    string BFS(T start, int threads);
+
+    // Bit-parallel multi-source BFS: up to 256 starts share one pass over the adjacency
+    // lists. result[i] holds the vertices within maxDepth of starts[i] (excluding it),
+    // ordered by distance then insertion order.
+    vector<vector<T>> multiSourceBFS(vector<T> starts, int maxDepth);
+
+    // True when a directed path (possibly empty) leads from -> to
+    bool reachable(T from, T to);
+
+    // Weighted shortest paths over Edge::weight. NegativeWeightException is thrown when
+    // a negative weight leaves a vertex reachable from `from`; edges the query never
+    // reaches are not checked, whatever the thread count. With threads > 1
+    // shortestDistances runs parallel delta-stepping over the frozen CSR.
+    PathResult<T> shortestPath(T from, T to);
+    vector<pair<T,float>> shortestDistances(T from, int threads = 1);
+
+    // Binary snapshot, see SnapshotHeader. save() compacts first, load() replaces
+    // the graph's contents; use GraphSnapshot directly to query a file without
+    // materialising it. Edge labels are stored with the edges.
+    void save(string path);
+    void load(string path);
+
+    // See CommonAncestorEngine; returns false when a and b share no ancestor
+    bool nearestCommonAncestor(T a, T b, T &result, uint32_t label = ANY_LABEL);
+    bool buildAncestorIndex();
+
+    void freeze();
+    void thaw();
+    bool isFrozen();
+
+    MemoryUsage memoryUsage();
+    // Drops spare capacity from nodeList, the adjacency lists, the vertex
+    // lookup table and the traversal scratch buffers
+    void shrinkToFit();
+
+    // Single-writer concurrency: any number of threads may query through read()
+    // while one writer keeps mutating. Readers see nothing of the writer's changes
+    // until publish(), which makes every mutation since the last publish visible
+    // at once and returns the new version number. It compacts the graph first.
+    // Every live ReadView holds a reader slot, see EpochDomain.
+    uint64_t publish();
+    ReadView<T> read();
+
+    // Read-only copy in the compressed layout, see CompressedGraph. Compacts first.
+    // The copy drops edge labels.
+    CompressedGraph<T> compress(bool inEdges = false);
+
+    void beginVisit();
+    bool markVisited(VertexNode<T>* node);
+    bool isVisited(VertexNode<T>* node);
+    bool markVisited(int id);
+
+    friend class CommonAncestorEngine<T>;
+    friend class KnowledgeGraph;
+};
+
+// =====================================
+// Struct BulkLoadReport
+// =====================================
+struct BulkLoadReport {
+    int accepted;
+    vector<pair<size_t, string>> rejected; // <input row, reason>
+};
+
+// =====================================
+// Struct ImportReport
+// =====================================
+struct ImportReport {
+    size_t lines;
+    size_t relations;       // rows connected (or already connected)
+    size_t entitiesAdded;
+    size_t bytes;
+    double seconds;
+    double megabytesPerSecond;
+    vector<pair<size_t, string>> errors;    // <1-based line, reason>
 };
 
 // =====================================
@@ -119,28 +1096,113 @@ class KnowledgeGraph {
         friend class TestHelper;
     #endif
 private:
-    DGraphModel<string> graph;
-    vector<string> entities;
+    // Entity names are interned; symbol id i is always graph vertex i, so
+    // compaction swaps symbols along with the nodes
+    DGraphModel<uint32_t> graph;
+    SymbolTable symbols;
+    // Relation labels; label name i is edge label i + 1, the empty name is 0
+    SymbolTable labels;
+    // Published versions carry their own copy of the names, so readers never touch symbols
+    EpochDomain epochs;
+    atomic<GraphVersion<string>*> published;
+    uint64_t versions;
+
+    VertexNode<uint32_t>* createEntity(string_view name);
+    VertexNode<uint32_t>* entityNode(string &entity);
+    VertexNode<uint32_t>* entityNode(uint32_t id);
+    void connectBulk(vector<pair<VertexNode<uint32_t>*, VertexNode<uint32_t>*>> &endpoints, vector<float> &weights);
+    vector<string> names(const vector<uint32_t> &ids);
+    bool findLabel(string &label, uint32_t &id);
+    string joinNames(const vector<uint32_t> &ids);
 
 public:
     static bool stringEQ(string &a, string &b);
     static string string2str(string &a);
+    static size_t stringHash(string &a);
     KnowledgeGraph();
+    ~KnowledgeGraph();
     
     void addEntity(string entity);
     void addRelation(string from, string to, float weight = 1.0f);
+    // Typed relation such as "is_a" or "part_of"; "" is the unlabeled relation
+    // the overload above adds. Two entities hold one relation per label, adding
+    // an existing one again keeps its weight.
+    void addRelation(string from, string to, float weight, string label);
+    // Label of the first relation from -> to, and the labels of all of them
+    string relationLabel(string from, string to);
+    vector<string> relationLabels(string from, string to);
+    // Drops the entity and its relations; its id stays unused until compact()
+    void removeEntity(string entity);
+    // See DGraphModel::compact; save() and publish() finish any pending compaction
+    bool compact(int budget = INT_MAX);
+    // See DGraphModel::reorder; entity ids and query results are unchanged
+    void reorder(VertexLayout layout = LAYOUT_BFS);
+    BulkLoadReport addEntities(const vector<string> &names);
+    BulkLoadReport addRelations(const vector<tuple<string, string, float>> &relations);
+    // Streams "from<delimiter>to[<delimiter>weight]" lines from a mapped file, parsing
+    // chunks on several threads. Unknown entities are created, the weight defaults
+    // to 1, blank lines and lines starting with '#' are skipped.
+    ImportReport importEdgeList(string path, char delimiter = '\t', int threads = 1);
     
     vector<string> getAllEntities();
     vector<string> getNeighbors(string entity);
+    // The label filtered overloads follow only relations with that label
+    vector<string> getNeighbors(string entity, string label);
     
     string bfs(string start);
+    string bfs(string start, string label);
     string dfs(string start);
+    // Visitor receives (entity, depth, parent entity or nullptr) and returns false to stop.
+    void bfs(string start, function<bool(string&, int, string*)> visit);
+    void dfs(string start, function<bool(string&, int, string*)> visit);
     
     bool isReachable(string from, string to);
     string toString();
+
+    void freeze();
+    void thaw();
+
+    // The graph's usage plus the interned names
+    MemoryUsage memoryUsage();
+    void shrinkToFit();
+
+    // Lock-free reads during writes: reader() threads see the entities and relations
+    // as of the last publish(), while one writer keeps adding. ReadView::related()
+    // is the getRelatedEntities counterpart. Versions keep the relation labels;
+    // ReadView::findLabel() turns a name into the label its filtered walks take.
+    // Each live view takes one reader slot; there is no fixed limit on views, the
+    // slots grow 64 at a time and are kept until the graph is destroyed.
+    uint64_t publish();
+    ReadView<string> reader();
     
     vector<string> getRelatedEntities(string entity, int depth = 2);
+    // Same set as above, ordered by distance then insertion order, computed with a parallel BFS
+    vector<string> getRelatedEntities(string entity, int depth, int threads);
+    vector<string> getRelatedEntities(string entity, int depth, string label);
+    // One result per seed, each ordered by distance then insertion order
+    vector<vector<string>> getRelatedEntitiesBatch(vector<string> entities, int depth = 2);
     string findCommonAncestors(string entity1, string entity2);
+    string findCommonAncestors(string entity1, string entity2, string label);
+    bool buildAncestorIndex();
+
+    // The snapshot keeps relation labels and their names
+    void save(string path);
+    void load(string path);
+
+    PathResult<string> shortestPath(string from, string to);
+    vector<pair<string,float>> shortestDistances(string from, int threads = 1);
+
+    // Id-level API: ids are dense, assigned in insertion order, and skip name lookups.
+    // Removed entities leave gaps until compaction renumbers the survivors.
+    int entityCount();
+    uint32_t idOf(string entity);
+    string_view nameOf(uint32_t id);   // valid until the next entity is added or compaction
+    vector<uint32_t> neighbors(uint32_t id);
+    vector<uint32_t> bfs(uint32_t start);
+    vector<uint32_t> dfs(uint32_t start);
+    bool isReachable(uint32_t from, uint32_t to);
+    vector<uint32_t> getRelatedEntities(uint32_t entity, int depth);
+
     vector<pair<string,int>> collectancestor(string &start);
 };
 
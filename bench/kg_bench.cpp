@@ -0,0 +1,386 @@
+#include "../KnowledgeGraph.h"
+#include <chrono>
+#include <random>
+#include <unordered_set>
+
+// Operation benchmark for DGraphModel and KnowledgeGraph on synthetic graphs.
+// Build: cmake -S . -B build && cmake --build build --target kg_bench
+// Usage: ./kg_bench [--sizes 1K,10K,100K] [--generators er,powerlaw,tree,dag,hubs]
+//                   [--degree 4] [--queries 1000] [--seed 42] [--out results.json]
+// Sizes take K/M suffixes (1K .. 10M). Results are written as JSON, to stdout
+// unless --out is given, so two runs can be diffed or compared by a script.
+
+typedef vector<pair<int,int>> EdgeList;
+
+// Erdős–Rényi G(n, m) with m = n * degree uniformly random edges
+static EdgeList generateErdosRenyi(int vertices, int degree, mt19937 &rng)
+{
+    EdgeList edges;
+    if(vertices < 2) return edges;
+    edges.reserve((size_t)vertices * degree);
+    for(size_t k = 0; k < (size_t)vertices * degree; k++)
+    {
+        int from = rng() % vertices;
+        int to = rng() % vertices;
+        if(from != to) edges.push_back({from, to});
+    }
+    return edges;
+}
+
+// Preferential attachment: each new vertex links to endpoints of random earlier
+// edges, which yields a power-law degree distribution.
+static EdgeList generatePowerLaw(int vertices, int degree, mt19937 &rng)
+{
+    EdgeList edges;
+    vector<int> endpoints;
+    for(int v = 1; v < vertices; v++)
+    {
+        for(int k = 0; k < degree; k++)
+        {
+            int target = endpoints.empty() ? 0 : endpoints[rng() % endpoints.size()];
+            if(target == v) continue;
+            if(rng() & 1) edges.push_back({v, target});
+            else edges.push_back({target, v});
+            endpoints.push_back(target);
+            endpoints.push_back(v);
+        }
+    }
+    return edges;
+}
+
+// Deep tree: the parent of v is one of the four vertices just before it, so the
+// depth grows linearly with the size. Edges point parent -> child.
+static EdgeList generateDeepTree(int vertices, mt19937 &rng)
+{
+    EdgeList edges;
+    edges.reserve(vertices);
+    for(int v = 1; v < vertices; v++)
+        edges.push_back({v - 1 - (int)(rng() % min(v, 4)), v});
+    return edges;
+}
+
+// Taxonomy DAG: every vertex gets 1..3 parents among the 1000 vertices before it.
+// Edges point parent -> child.
+static EdgeList generateTaxonomy(int vertices, mt19937 &rng)
+{
+    EdgeList edges;
+    for(int v = 1; v < vertices; v++)
+    {
+        int window = min(v, 1000);
+        int parents = 1 + rng() % 3;
+        for(int k = 0; k < parents && k < window; k++)
+            edges.push_back({v - 1 - (int)(rng() % window), v});
+    }
+    return edges;
+}
+
+// Category hubs: the first 16 vertices are categories and every other vertex
+// is a member of one of them (category -> member), plus degree - 1 random edges.
+static EdgeList generateCategoryHubs(int vertices, int degree, mt19937 &rng)
+{
+    EdgeList edges;
+    int hubs = min(vertices, 16);
+    for(int v = hubs; v < vertices; v++)
+    {
+        edges.push_back({(int)(rng() % hubs), v});
+        for(int k = 1; k < degree; k++)
+        {
+            int to = rng() % vertices;
+            if(to != v) edges.push_back({v, to});
+        }
+    }
+    return edges;
+}
+
+static size_t intHash(int &v)
+{
+    return v;
+}
+
+static string int2str(int &v)
+{
+    return to_string(v);
+}
+
+struct BenchResult {
+    string generator;
+    int vertices;
+    size_t edges;
+    string api;
+    string op;
+    size_t ops;
+    double ms;
+    double bytesPerEdge;    // storage cost, only reported for the storage rows
+    string memory;          // MemoryUsage::toJSON() for the memoryUsage rows
+};
+
+static vector<BenchResult> results;
+static size_t sink = 0;     // folds every query result in so nothing is optimised away
+
+template <class F>
+static void measure(string generator, int vertices, size_t edges, string api, string op, size_t ops, F body)
+{
+    auto begin = chrono::steady_clock::now();
+    body();
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    results.push_back({generator, vertices, edges, api, op, ops, ms, -1, ""});
+    cerr << generator << " n=" << vertices << " " << api << "::" << op << " " << ms << " ms" << endl;
+}
+
+static void recordMemory(MemoryUsage &usage, size_t edges)
+{
+    results.back().bytesPerEdge = edges ? (double)usage.total() / edges : 0;
+    results.back().memory = usage.toJSON();
+}
+
+static int parseSize(string text)
+{
+    double value = atof(text.c_str());
+    char suffix = text.empty() ? 0 : toupper(text.back());
+    if(suffix == 'K') value *= 1e3;
+    if(suffix == 'M') value *= 1e6;
+    return (int)value;
+}
+
+static vector<string> splitList(string text)
+{
+    vector<string> items;
+    stringstream ss(text);
+    string item;
+    while(getline(ss, item, ','))
+    {
+        if(!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static void runDGraphModel(string generator, int vertices, EdgeList &edges, vector<int> &starts, mt19937 &rng)
+{
+    DGraphModel<int> graph(nullptr, int2str, intHash);
+    size_t m = edges.size();
+    size_t queries = starts.size();
+    // Whole-graph traversals are capped so the large sizes finish in reasonable time
+    size_t traversals = max<size_t>(1, min<size_t>(queries, 4000000 / (vertices + m + 1)));
+
+    measure(generator, vertices, m, "DGraphModel", "add", vertices, [&]() {
+        graph.reserve(vertices);
+        for(int v = 0; v < vertices; v++) graph.add(v);
+    });
+    measure(generator, vertices, m, "DGraphModel", "connect", m, [&]() {
+        for(auto &edge : edges) graph.connect(edge.first, edge.second, 1);
+    });
+    MemoryUsage usage;
+    measure(generator, vertices, m, "DGraphModel", "memoryUsage", 1, [&]() {
+        usage = graph.memoryUsage();
+    });
+    recordMemory(usage, m);
+    measure(generator, vertices, m, "DGraphModel", "BFS", traversals, [&]() {
+        for(size_t i = 0; i < traversals; i++) sink += graph.BFS(starts[i]).size();
+    });
+    measure(generator, vertices, m, "DGraphModel", "DFS", traversals, [&]() {
+        for(size_t i = 0; i < traversals; i++) sink += graph.DFS(starts[i]).size();
+    });
+
+    unique_ptr<CompressedGraph<int>> packed;
+    measure(generator, vertices, m, "CompressedGraph", "compress", 1, [&]() {
+        packed.reset(new CompressedGraph<int>(graph.compress()));
+    });
+    results.back().bytesPerEdge = packed->edgeCount() ? (double)packed->adjacencyBytes() / packed->edgeCount() : 0;
+    measure(generator, vertices, m, "CompressedGraph", "BFS", traversals, [&]() {
+        for(size_t i = 0; i < traversals; i++) sink += packed->BFS(starts[i]).size();
+    });
+    measure(generator, vertices, m, "CompressedGraph", "DFS", traversals, [&]() {
+        for(size_t i = 0; i < traversals; i++) sink += packed->DFS(starts[i]).size();
+    });
+
+    // Distinct existing edges, picked before the clock starts
+    EdgeList victims;
+    unordered_set<long long> picked;
+    for(size_t tries = 0; victims.size() < queries && tries < 4 * queries && m > 0; tries++)
+    {
+        auto &edge = edges[rng() % m];
+        if(picked.insert((long long)edge.first * vertices + edge.second).second)
+            victims.push_back(edge);
+    }
+    measure(generator, vertices, m, "DGraphModel", "disconnect", victims.size(), [&]() {
+        for(auto &edge : victims) graph.disconnect(edge.first, edge.second);
+    });
+}
+
+static void runKnowledgeGraph(string generator, int vertices, EdgeList &edges, vector<int> &starts, vector<int> &targets, size_t toStringMax)
+{
+    KnowledgeGraph kg;
+    size_t m = edges.size();
+    size_t queries = starts.size();
+    size_t traversals = max<size_t>(1, min<size_t>(queries, 4000000 / (vertices + m + 1)));
+    vector<string> names(vertices);
+    for(int v = 0; v < vertices; v++) names[v] = "entity_" + to_string(v);
+
+    measure(generator, vertices, m, "KnowledgeGraph", "addEntity", vertices, [&]() {
+        for(auto &name : names) kg.addEntity(name);
+    });
+    measure(generator, vertices, m, "KnowledgeGraph", "addRelation", m, [&]() {
+        for(auto &edge : edges) kg.addRelation(names[edge.first], names[edge.second]);
+    });
+    MemoryUsage usage;
+    measure(generator, vertices, m, "KnowledgeGraph", "memoryUsage", 1, [&]() {
+        usage = kg.memoryUsage();
+    });
+    recordMemory(usage, m);
+    measure(generator, vertices, m, "KnowledgeGraph", "bfs", traversals, [&]() {
+        for(size_t i = 0; i < traversals; i++) sink += kg.bfs(names[starts[i]]).size();
+    });
+    measure(generator, vertices, m, "KnowledgeGraph", "dfs", traversals, [&]() {
+        for(size_t i = 0; i < traversals; i++) sink += kg.dfs(names[starts[i]]).size();
+    });
+    measure(generator, vertices, m, "KnowledgeGraph", "getRelatedEntities", queries, [&]() {
+        for(size_t i = 0; i < queries; i++) sink += kg.getRelatedEntities(names[starts[i]], 2).size();
+    });
+    measure(generator, vertices, m, "KnowledgeGraph", "findCommonAncestors", queries, [&]() {
+        for(size_t i = 0; i < queries; i++) sink += kg.findCommonAncestors(names[starts[i]], names[targets[i]]).size();
+    });
+    // The first query pays for building the reachability index
+    measure(generator, vertices, m, "KnowledgeGraph", "isReachable.first", 1, [&]() {
+        sink += kg.isReachable(names[starts[0]], names[targets[0]]);
+    });
+    measure(generator, vertices, m, "KnowledgeGraph", "isReachable", queries, [&]() {
+        for(size_t i = 0; i < queries; i++) sink += kg.isReachable(names[starts[i]], names[targets[i]]);
+    });
+    if((size_t)vertices <= toStringMax)
+    {
+        measure(generator, vertices, m, "KnowledgeGraph", "toString", 1, [&]() {
+            sink += kg.toString().size();
+        });
+    }
+}
+
+// Same graph with typed relations: every 20th edge is "is_a", the rest "related_to",
+// so the labelled queries follow about 5% of the edges
+static void runLabelledRelations(string generator, int vertices, EdgeList &edges, vector<int> &starts, vector<int> &targets)
+{
+    KnowledgeGraph kg;
+    size_t m = edges.size();
+    size_t queries = starts.size();
+    size_t traversals = max<size_t>(1, min<size_t>(queries, 4000000 / (vertices + m + 1)));
+    vector<string> names(vertices);
+    for(int v = 0; v < vertices; v++) names[v] = "entity_" + to_string(v);
+    for(auto &name : names) kg.addEntity(name);
+
+    measure(generator, vertices, m, "KnowledgeGraph", "addRelation(label)", m, [&]() {
+        for(size_t i = 0; i < m; i++)
+            kg.addRelation(names[edges[i].first], names[edges[i].second], 1.0f, i % 20 == 0 ? "is_a" : "related_to");
+    });
+    measure(generator, vertices, m, "KnowledgeGraph", "getNeighbors(label)", queries, [&]() {
+        for(size_t i = 0; i < queries; i++) sink += kg.getNeighbors(names[starts[i]], "is_a").size();
+    });
+    measure(generator, vertices, m, "KnowledgeGraph", "bfs(label)", traversals, [&]() {
+        for(size_t i = 0; i < traversals; i++) sink += kg.bfs(names[starts[i]], "is_a").size();
+    });
+    measure(generator, vertices, m, "KnowledgeGraph", "getRelatedEntities(label)", queries, [&]() {
+        for(size_t i = 0; i < queries; i++) sink += kg.getRelatedEntities(names[starts[i]], 2, "is_a").size();
+    });
+    measure(generator, vertices, m, "KnowledgeGraph", "findCommonAncestors(label)", queries, [&]() {
+        for(size_t i = 0; i < queries; i++) sink += kg.findCommonAncestors(names[starts[i]], names[targets[i]], "is_a").size();
+    });
+}
+
+static void writeJson(ostream &out, vector<int> &sizes, vector<string> &generators, int degree, int queries, unsigned seed)
+{
+    out << "{\n";
+    out << "  \"benchmark\": \"kg_bench\",\n";
+    out << "  \"degree\": " << degree << ",\n";
+    out << "  \"queries\": " << queries << ",\n";
+    out << "  \"seed\": " << seed << ",\n";
+    out << "  \"sizes\": [";
+    for(size_t i = 0; i < sizes.size(); i++) out << (i ? ", " : "") << sizes[i];
+    out << "],\n";
+    out << "  \"generators\": [";
+    for(size_t i = 0; i < generators.size(); i++) out << (i ? ", " : "") << "\"" << generators[i] << "\"";
+    out << "],\n";
+    out << "  \"results\": [\n";
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        BenchResult &r = results[i];
+        out << "    {\"generator\": \"" << r.generator << "\", \"vertices\": " << r.vertices
+            << ", \"edges\": " << r.edges << ", \"api\": \"" << r.api << "\", \"op\": \"" << r.op
+            << "\", \"ops\": " << r.ops << ", \"total_ms\": " << r.ms
+            << ", \"ns_per_op\": " << (r.ops ? r.ms * 1e6 / r.ops : 0);
+        if(r.bytesPerEdge >= 0) out << ", \"bytes_per_edge\": " << r.bytesPerEdge;
+        if(!r.memory.empty()) out << ", \"memory\": " << r.memory;
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"checksum\": " << sink << "\n";
+    out << "}\n";
+}
+
+int main(int argc, char **argv)
+{
+    vector<int> sizes = {1000, 10000, 100000};
+    vector<string> generators = {"er", "powerlaw", "tree", "dag", "hubs"};
+    int degree = 4;
+    int queries = 1000;
+    unsigned seed = 42;
+    size_t toStringMax = 1000000;
+    string outPath;
+    for(int i = 1; i + 1 < argc; i += 2)
+    {
+        string flag = argv[i];
+        string value = argv[i + 1];
+        if(flag == "--sizes")
+        {
+            sizes.clear();
+            for(auto &item : splitList(value)) sizes.push_back(parseSize(item));
+        }
+        else if(flag == "--generators") generators = splitList(value);
+        else if(flag == "--degree") degree = atoi(value.c_str());
+        else if(flag == "--queries") queries = atoi(value.c_str());
+        else if(flag == "--seed") seed = atoi(value.c_str());
+        else if(flag == "--tostring-max") toStringMax = parseSize(value);
+        else if(flag == "--out") outPath = value;
+        else
+        {
+            cerr << "unknown option " << flag << endl;
+            return 1;
+        }
+    }
+    if(queries < 1) queries = 1;
+
+    for(auto &generator : generators)
+    {
+        for(int vertices : sizes)
+        {
+            if(vertices < 1) continue;
+            mt19937 rng(seed);
+            EdgeList edges;
+            if(generator == "er") edges = generateErdosRenyi(vertices, degree, rng);
+            else if(generator == "powerlaw") edges = generatePowerLaw(vertices, degree, rng);
+            else if(generator == "tree") edges = generateDeepTree(vertices, rng);
+            else if(generator == "dag") edges = generateTaxonomy(vertices, rng);
+            else if(generator == "hubs") edges = generateCategoryHubs(vertices, degree, rng);
+            else
+            {
+                cerr << "unknown generator " << generator << endl;
+                return 1;
+            }
+            vector<int> starts(queries);
+            vector<int> targets(queries);
+            for(int i = 0; i < queries; i++)
+            {
+                starts[i] = rng() % vertices;
+                targets[i] = rng() % vertices;
+            }
+            runDGraphModel(generator, vertices, edges, starts, rng);
+            runKnowledgeGraph(generator, vertices, edges, starts, targets, toStringMax);
+            runLabelledRelations(generator, vertices, edges, starts, targets);
+        }
+    }
+
+    if(outPath.empty()) writeJson(cout, sizes, generators, degree, queries, seed);
+    else
+    {
+        ofstream out(outPath);
+        writeJson(out, sizes, generators, degree, queries, seed);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include "../KnowledgeGraph.h"
+#include <chrono>
+#include <random>
+
+// Scaling benchmark for DGraphModel's parallel level-synchronous BFS.
+// Build: cmake -S . -B build && cmake --build build --target parallel_bfs_bench
+//    or: g++ -std=c++17 -O2 -pthread bench/parallel_bfs_bench.cpp KnowledgeGraph.cpp -o parallel_bfs_bench
+// Usage: ./parallel_bfs_bench [vertices] [edges per vertex] [max threads]
+
+// Preferential attachment: each new vertex links to endpoints of random earlier
+// edges, which yields a power-law degree distribution.
+static void buildPowerLaw(DGraphModel<int> &graph, int vertices, int degree, mt19937 &rng)
+{
+    vector<int> endpoints;
+    graph.reserve(vertices);
+    for(int v = 0; v < vertices; v++)
+    {
+        graph.add(v);
+        for(int k = 0; k < degree && v > 0; k++)
+        {
+            int target = endpoints.empty() ? 0 : endpoints[rng() % endpoints.size()];
+            if(target == v) continue;
+            if(rng() & 1) graph.connect(v, target);
+            else graph.connect(target, v);
+            endpoints.push_back(target);
+            endpoints.push_back(v);
+        }
+    }
+}
+
+static size_t intHash(int &v)
+{
+    return v;
+}
+
+int main(int argc, char **argv)
+{
+    int vertices = argc > 1 ? atoi(argv[1]) : 200000;
+    int degree = argc > 2 ? atoi(argv[2]) : 8;
+    int maxThreads = argc > 3 ? atoi(argv[3]) : (int)thread::hardware_concurrency();
+    if(maxThreads < 1) maxThreads = 1;
+
+    mt19937 rng(42);
+    DGraphModel<int> graph(nullptr, nullptr, intHash);
+    buildPowerLaw(graph, vertices, degree, rng);
+    graph.freeze();
+
+    vector<int> sources;
+    for(int i = 0; i < 8; i++) sources.push_back(rng() % vertices);
+
+    double baseline = 0;
+    vector<vector<vector<int>>> reference;
+    cout << "threads\tms\tspeedup" << endl;
+    for(int threads = 1; ; threads = min(threads * 2, maxThreads))
+    {
+        auto begin = chrono::steady_clock::now();
+        vector<vector<vector<int>>> results;
+        for(int source : sources)
+            results.push_back(graph.BFSLevels(source, threads));
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+        if(threads == 1)
+        {
+            baseline = ms;
+            reference = results;
+        }
+        else if(results != reference)
+        {
+            cout << "level sets differ at " << threads << " threads" << endl;
+            return 1;
+        }
+        cout << threads << "\t" << ms << "\t" << baseline / ms << endl;
+        if(threads == maxThreads) break;
+    }
+    return 0;
+}
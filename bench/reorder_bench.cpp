@@ -0,0 +1,168 @@
+#include "../KnowledgeGraph.h"
+#include <chrono>
+#include <random>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+// Traversal cost of DGraphModel before and after reorder() with each layout.
+// Build: cmake -S . -B build && cmake --build build --target reorder_bench
+//    or: g++ -std=c++17 -O2 -pthread bench/reorder_bench.cpp KnowledgeGraph.cpp -o reorder_bench
+// Usage: ./reorder_bench [vertices] [generator: grid|powerlaw] [edges per vertex]
+// Cache misses come from perf_event_open and read "n/a" where the kernel does
+// not allow it (see /proc/sys/kernel/perf_event_paranoid).
+
+// 2D grid with 4-neighbour edges both ways plus degree - 4 random shortcuts per
+// vertex. Vertex ids are a random permutation of the grid cells and edges are
+// added in random order, so neither the ids nor the allocation order carry
+// any locality.
+static vector<pair<int,int>> generateGrid(int vertices, int degree, mt19937 &rng)
+{
+    int side = max(1, (int)sqrt((double)vertices));
+    vector<int> cell(vertices);
+    for(int v = 0; v < vertices; v++) cell[v] = v;
+    shuffle(cell.begin(), cell.end(), rng);
+    vector<pair<int,int>> edges;
+    for(int v = 0; v < vertices; v++)
+    {
+        int x = v % side, y = v / side;
+        if(x + 1 < side && v + 1 < vertices) edges.push_back({cell[v], cell[v + 1]});
+        if(x > 0) edges.push_back({cell[v], cell[v - 1]});
+        if(v + side < vertices) edges.push_back({cell[v], cell[v + side]});
+        if(y > 0) edges.push_back({cell[v], cell[v - side]});
+        for(int k = 4; k < degree; k++) edges.push_back({cell[v], (int)(rng() % vertices)});
+    }
+    shuffle(edges.begin(), edges.end(), rng);
+    return edges;
+}
+
+// Preferential attachment, each vertex linking to endpoints of earlier edges
+static vector<pair<int,int>> generatePowerLaw(int vertices, int degree, mt19937 &rng)
+{
+    vector<pair<int,int>> edges;
+    vector<int> endpoints;
+    for(int v = 1; v < vertices; v++)
+    {
+        for(int k = 0; k < degree; k++)
+        {
+            int target = endpoints.empty() ? 0 : endpoints[rng() % endpoints.size()];
+            if(target == v) continue;
+            if(rng() & 1) edges.push_back({v, target});
+            else edges.push_back({target, v});
+            endpoints.push_back(target);
+            endpoints.push_back(v);
+        }
+    }
+    shuffle(edges.begin(), edges.end(), rng);
+    return edges;
+}
+
+static size_t intHash(int &v)
+{
+    return v;
+}
+
+// Last-level cache misses of this thread, user space only; -1 when unavailable
+class CacheMissCounter {
+private:
+    int fd;
+
+public:
+    CacheMissCounter()
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    ~CacheMissCounter()
+    {
+        if(fd >= 0) close(fd);
+    }
+
+    void start()
+    {
+        if(fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    long long stop()
+    {
+        if(fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if(read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+    }
+};
+
+static string missText(long long misses)
+{
+    return misses < 0 ? "n/a" : to_string(misses);
+}
+
+int main(int argc, char **argv)
+{
+    int vertices = argc > 1 ? atoi(argv[1]) : 1000000;
+    string generator = argc > 2 ? argv[2] : "grid";
+    int degree = argc > 3 ? atoi(argv[3]) : 6;
+    if(vertices < 1) vertices = 1;
+
+    mt19937 rng(42);
+    vector<pair<int,int>> edges = generator == "powerlaw" ? generatePowerLaw(vertices, degree, rng)
+                                                          : generateGrid(vertices, degree, rng);
+    DGraphModel<int> graph(nullptr, nullptr, intHash);
+    graph.reserve(vertices);
+    for(int v = 0; v < vertices; v++) graph.add(v);
+    for(auto &edge : edges) graph.connect(edge.first, edge.second);
+
+    vector<int> sources;
+    for(int i = 0; i < 4; i++) sources.push_back(rng() % vertices);
+
+    CacheMissCounter counter;
+    size_t reference = 0;
+    cout << "layout\treorder_ms\tbfs_ms\tbfs_misses\tdfs_ms\tdfs_misses" << endl;
+    vector<pair<string, int>> layouts = {{"insertion", -1}, {"bfs", LAYOUT_BFS}, {"rcm", LAYOUT_RCM}, {"degree", LAYOUT_DEGREE}};
+    for(auto &layout : layouts)
+    {
+        auto begin = chrono::steady_clock::now();
+        if(layout.second >= 0) graph.reorder((VertexLayout)layout.second);
+        double reorderMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        // The visit order does not depend on the layout, so neither does the checksum
+        size_t checksum = 0;
+        double ms[2];
+        long long misses[2];
+        for(int walk = 0; walk < 2; walk++)
+        {
+            begin = chrono::steady_clock::now();
+            counter.start();
+            for(int source : sources)
+            {
+                size_t position = 0;
+                auto visit = [&](VertexNode<int> &node, int, VertexNode<int>*) {
+                    checksum += (size_t)node.getVertex() * ++position;
+                    return true;
+                };
+                if(walk == 0) graph.traverseBFS(source, visit);
+                else graph.traverseDFS(source, visit);
+            }
+            misses[walk] = counter.stop();
+            ms[walk] = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+        }
+        if(layout.second < 0) reference = checksum;
+        else if(checksum != reference)
+        {
+            cerr << "traversal order changed after reorder(" << layout.first << ")" << endl;
+            return 1;
+        }
+        cout << layout.first << "\t" << reorderMs << "\t" << ms[0] << "\t" << missText(misses[0])
+             << "\t" << ms[1] << "\t" << missText(misses[1]) << endl;
+    }
+    return 0;
+}
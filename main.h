@@ -7,6 +7,28 @@
 #include <stdexcept>
 #include <cmath>
 #include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <climits>
+#include <cstring>
+#include <string_view>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "utils.h"
 
 using namespace std;
@@ -27,6 +49,18 @@ public:
     explicit EdgeNotFoundException(const std::string& what_arg) : std::logic_error(what_arg) {}
 };
 
+class NegativeWeightException : public std::logic_error {
+public:
+    NegativeWeightException() : std::logic_error("Negative edge weight!") {}
+    explicit NegativeWeightException(const std::string& what_arg) : std::logic_error(what_arg) {}
+};
+
+class SnapshotException : public std::runtime_error {
+public:
+    SnapshotException() : std::runtime_error("Invalid snapshot!") {}
+    explicit SnapshotException(const std::string& what_arg) : std::runtime_error(what_arg) {}
+};
+
 // =============================================================================
 // KNOWLEDGE GRAPH EXCEPTIONS
 // =============================================================================
@@ -43,5 +77,11 @@ public:
     explicit EntityNotFoundException(const std::string& what_arg) : std::logic_error(what_arg) {}
 };
 
+class ImportException : public std::runtime_error {
+public:
+    ImportException() : std::runtime_error("Cannot read import file!") {}
+    explicit ImportException(const std::string& what_arg) : std::runtime_error(what_arg) {}
+};
+
 
 #endif // __MAIN_H__
@@ -0,0 +1,105 @@
+#include "check.h"
+
+// Checks for DGraphModel::nearestCommonAncestor: on random graphs the answer
+// must be a common ancestor (other than a and b) with the smallest total
+// distance found by brute force, or none when no such vertex exists. On random
+// forests the jump-pointer index from buildAncestorIndex must give the same
+// answers as the search, and an edge change must send queries back to it.
+
+// Smallest dist(v, a) + dist(v, b) over the common ancestors v, -1 for none
+static int bestTotal(DGraphModel<int> &g, int a, int b)
+{
+    vector<int> fromA = hopDistances(g, a, true);
+    vector<int> fromB = hopDistances(g, b, true);
+    int best = -1;
+    for(int v = 0; v < g.size(); v++)
+    {
+        if(v == a || v == b || fromA[v] < 0 || fromB[v] < 0) continue;
+        if(best < 0 || fromA[v] + fromB[v] < best) best = fromA[v] + fromB[v];
+    }
+    return best;
+}
+
+static void compare(DGraphModel<int> &g, int a, int b, string what)
+{
+    int expected = bestTotal(g, a, b);
+    int result = -1;
+    bool found = g.nearestCommonAncestor(a, b, result);
+    check(found == (expected >= 0), what + ": found");
+    if(!found || expected < 0) return;
+    vector<int> fromA = hopDistances(g, a, true);
+    vector<int> fromB = hopDistances(g, b, true);
+    check(result != a && result != b && fromA[result] >= 0 && fromB[result] >= 0 &&
+          fromA[result] + fromB[result] == expected, what + ": total distance");
+}
+
+// Vertices 0 .. n-1 hung under random earlier vertices of a shuffled order
+static void randomForest(DGraphModel<int> &g, int n, mt19937 &rng)
+{
+    vector<int> order(n);
+    for(int i = 0; i < n; i++)
+    {
+        g.add(i);
+        order[i] = i;
+    }
+    shuffle(order.begin(), order.end(), rng);
+    for(int i = 1; i < n; i++)
+    {
+        if(rng() % 8 != 0) g.connect(order[rng() % i], order[i]);
+    }
+}
+
+int main()
+{
+    mt19937 rng(11);
+    for(int trial = 0; trial < 60; trial++)
+    {
+        int n = 2 + rng() % 200;
+        DGraphModel<int> g;
+        randomGraph(g, n, rng() % (3 * n + 1), rng);
+        for(int i = 0; i < 20; i++)
+        {
+            int a = rng() % n, b = rng() % n;
+            if(a != b) compare(g, a, b, "graph " + to_string(trial) + " (" + to_string(a) + ", " + to_string(b) + ")");
+        }
+    }
+
+    for(int trial = 0; trial < 60; trial++)
+    {
+        int n = 2 + rng() % 300;
+        DGraphModel<int> g;
+        randomForest(g, n, rng);
+        vector<pair<int,int>> queries;
+        vector<bool> searched;
+        vector<int> answers;
+        for(int i = 0; i < 30; i++)
+        {
+            int a = rng() % n, b = rng() % n;
+            if(a == b) continue;
+            int result = -1;
+            queries.push_back({a, b});
+            searched.push_back(g.nearestCommonAncestor(a, b, result));
+            answers.push_back(result);
+        }
+        string what = "forest " + to_string(trial);
+        check(g.buildAncestorIndex(), what + ": index builds");
+        for(size_t i = 0; i < queries.size(); i++)
+        {
+            int a = queries[i].first, b = queries[i].second, result = -1;
+            bool found = g.nearestCommonAncestor(a, b, result);
+            string query = what + " (" + to_string(a) + ", " + to_string(b) + ")";
+            check(found == searched[i] && (!found || result == answers[i]), query + ": index vs search");
+            compare(g, a, b, query + " indexed");
+        }
+        // A second parent makes it no forest: the index must stop answering
+        int child = rng() % n;
+        g.connect(rng() % n, child);
+        g.connect(rng() % n, child);
+        for(int i = 0; i < 10; i++)
+        {
+            int a = rng() % n, b = rng() % n;
+            if(a != b) compare(g, a, b, what + " after connect (" + to_string(a) + ", " + to_string(b) + ")");
+        }
+    }
+    return finish("ancestor_check");
+}
@@ -0,0 +1,37 @@
+#include "check.h"
+
+// Checks for DGraphModel::BFSLevels: the parallel direction-optimizing walk
+// (4 threads) must give the same levels as the serial one, and both must match
+// a plain BFS, on random graphs from sparse to dense and at several depths.
+
+int main()
+{
+    mt19937 rng(8);
+    for(int trial = 0; trial < 60; trial++)
+    {
+        int n = trial % 10 == 9 ? 3000 : 1 + rng() % 300;
+        int m = rng() % (8 * n + 1);
+        DGraphModel<int> g;
+        randomGraph(g, n, m, rng);
+        for(int i = 0; i < 4; i++)
+        {
+            int start = rng() % n;
+            string what = "trial " + to_string(trial) + " start " + to_string(start);
+            vector<int> dist = hopDistances(g, start);
+            vector<vector<int>> expected;
+            for(int v = 0; v < n; v++)
+            {
+                if(dist[v] < 0) continue;
+                if(dist[v] >= (int)expected.size()) expected.resize(dist[v] + 1);
+                expected[dist[v]].push_back(v);
+            }
+            vector<vector<int>> serial = g.BFSLevels(start, 1);
+            check(serial == expected, what + ": serial levels vs plain BFS");
+            check(g.BFSLevels(start, 4) == serial, what + ": 4 threads vs serial");
+            for(int depth : {-1, 0, 2})
+                check(g.BFSLevels(start, 4, depth) == g.BFSLevels(start, 1, depth),
+                      what + ": depth " + to_string(depth) + ", 4 threads vs serial");
+        }
+    }
+    return finish("bfs_check");
+}
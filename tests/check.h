@@ -0,0 +1,65 @@
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include "../KnowledgeGraph.h"
+#include <random>
+
+// Shared harness for the tests/*_check.cpp programs: check() records a failed
+// condition (safe to call from several threads), throwsA<E>() tells whether a
+// call throws E, and finish() prints the summary and gives main's exit code.
+// randomGraph() and hopDistances() give the differential checks a graph and a
+// plain BFS reference to compare against.
+// Each program runs through ctest, or directly as ./<name>.
+
+static atomic<int> failures(0);
+
+static void check(bool condition, string what)
+{
+    if(condition) return;
+    if(failures++ < 20) cerr << "FAILED: " << what << endl;
+}
+
+template <class E, class F>
+static bool throwsA(F call)
+{
+    try { call(); }
+    catch(E &) { return true; }
+    catch(...) { return false; }
+    return false;
+}
+
+static int finish(string name)
+{
+    if(failures == 0) cout << name << ": all passed" << endl;
+    return failures ? 1 : 0;
+}
+
+// Vertices 0 .. n-1 and m random edges; repeats collapse and self-loops stay.
+// Weights are 0, or 0 .. 9 when weighted.
+static void randomGraph(DGraphModel<int> &g, int n, int m, mt19937 &rng, bool weighted = false)
+{
+    for(int i = 0; i < n; i++) g.add(i);
+    for(int i = 0; i < m; i++)
+        g.connect(rng() % n, rng() % n, weighted ? (float)(rng() % 10) : 0);
+}
+
+// Hops from start along out-edges (in-edges when reverse), -1 when unreachable
+static vector<int> hopDistances(DGraphModel<int> &g, int start, bool reverse = false)
+{
+    vector<int> dist(g.size(), -1);
+    vector<int> queue = {start};
+    dist[start] = 0;
+    for(size_t i = 0; i < queue.size(); i++)
+    {
+        int u = queue[i];
+        for(int v : reverse ? g.getInwardEdges(u) : g.getOutwardEdges(u))
+        {
+            if(dist[v] >= 0) continue;
+            dist[v] = dist[u] + 1;
+            queue.push_back(v);
+        }
+    }
+    return dist;
+}
+
+#endif /* TESTS_CHECK_H */
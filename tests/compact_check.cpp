@@ -0,0 +1,129 @@
+#include "check.h"
+#include <map>
+#include <random>
+
+// Checks for KnowledgeGraph::removeEntity/compact: symbol id, node id and
+// vertex value must stay equal while compaction runs in small steps with
+// removals, re-added names and queries in between. Every answer is compared
+// with a plain model of the entities and relations.
+
+struct Model {
+    vector<string> entities;    // insertion order of the live entities
+    map<string, vector<pair<string, string>>> relations;   // from -> (to, label) in insertion order
+
+    bool contains(const string &entity)
+    {
+        return find(entities.begin(), entities.end(), entity) != entities.end();
+    }
+
+    void remove(const string &entity)
+    {
+        entities.erase(find(entities.begin(), entities.end(), entity));
+        relations.erase(entity);
+        for(auto &it : relations)
+        {
+            auto &edges = it.second;
+            edges.erase(remove_if(edges.begin(), edges.end(), [&](pair<string, string> &edge) {
+                return edge.first == entity;
+            }), edges.end());
+        }
+    }
+
+    vector<string> neighbors(const string &entity)
+    {
+        vector<string> result;
+        for(auto &edge : relations[entity])
+        {
+            if(find(result.begin(), result.end(), edge.first) == result.end()) result.push_back(edge.first);
+        }
+        return result;
+    }
+
+    bool reachable(const string &from, const string &to)
+    {
+        vector<string> queue = {from};
+        for(size_t i = 0; i < queue.size(); i++)
+        {
+            if(queue[i] == to) return true;
+            for(auto &next : neighbors(queue[i]))
+            {
+                if(find(queue.begin(), queue.end(), next) == queue.end()) queue.push_back(next);
+            }
+        }
+        return false;
+    }
+};
+
+static void compare(KnowledgeGraph &kg, Model &model, mt19937 &rng, string when)
+{
+    check(kg.getAllEntities() == model.entities, when + ": getAllEntities");
+    for(auto &entity : model.entities)
+        check(kg.getNeighbors(entity) == model.neighbors(entity), when + ": getNeighbors(" + entity + ")");
+    for(int i = 0; i < 20 && !model.entities.empty(); i++)
+    {
+        string &from = model.entities[rng() % model.entities.size()];
+        string &to = model.entities[rng() % model.entities.size()];
+        check(kg.isReachable(from, to) == model.reachable(from, to), when + ": isReachable(" + from + ", " + to + ")");
+    }
+}
+
+int main()
+{
+    const int names = 120;
+    const char *labels[] = {"", "is_a", "part_of"};
+    mt19937 rng(11);
+    KnowledgeGraph kg;
+    Model model;
+
+    for(int step = 0; step < 6000; step++)
+    {
+        if(step % 250 == 0) compare(kg, model, rng, "step " + to_string(step));
+        string name = "n" + to_string(rng() % names);
+        int op = rng() % 100;
+        if(op < 25)
+        {
+            if(model.contains(name)) continue;
+            kg.addEntity(name);
+            model.entities.push_back(name);
+        }
+        else if(op < 65)
+        {
+            string to = "n" + to_string(rng() % names);
+            if(!model.contains(name) || !model.contains(to)) continue;
+            string label = labels[rng() % 3];
+            kg.addRelation(name, to, 1, label);
+            auto &edges = model.relations[name];
+            if(find(edges.begin(), edges.end(), make_pair(to, label)) == edges.end()) edges.push_back({to, label});
+        }
+        else if(op < 80)
+        {
+            if(!model.contains(name)) continue;
+            kg.removeEntity(name);
+            model.remove(name);
+        }
+        else
+        {
+            kg.compact(1 + rng() % 3);
+        }
+    }
+    compare(kg, model, rng, "before compacting");
+    while(!kg.compact(2))
+        compare(kg, model, rng, "while compacting");
+    compare(kg, model, rng, "compacted");
+
+    string path = "compact_check_" + to_string(getpid()) + ".snap";
+    kg.save(path);
+    KnowledgeGraph loaded;
+    loaded.load(path);
+    unlink(path.c_str());
+    check(loaded.toString() == kg.toString(), "save/load: toString");
+    compare(loaded, model, rng, "loaded");
+    for(auto &it : model.relations)
+    {
+        for(auto &edge : it.second)
+            check(loaded.relationLabels(it.first, edge.first) == kg.relationLabels(it.first, edge.first),
+                  "save/load: relationLabels(" + it.first + ", " + edge.first + ")");
+    }
+
+    return finish("compact_check");
+}
@@ -0,0 +1,78 @@
+#include "check.h"
+
+// Checks for CompressedGraph: the varint layout built by compress() (with and
+// without in-edges) and by the edge-list constructor must report the same
+// vertices, neighbours, weights and degrees as the source graph, and its
+// BFS/DFS must match the source walked with neighbours in id order.
+
+static vector<int> sorted(vector<int> values)
+{
+    sort(values.begin(), values.end());
+    return values;
+}
+
+static void compare(CompressedGraph<int> &c, DGraphModel<int> &g, DGraphModel<int> &byId, string what)
+{
+    int n = g.size();
+    check(c.size() == n && c.vertices() == g.vertices(), what + ": vertices");
+    int edges = 0;
+    for(int u = 0; u < n; u++)
+    {
+        string at = what + " at " + to_string(u);
+        vector<int> out = sorted(g.getOutwardEdges(u));
+        edges += out.size();
+        check(c.getOutwardEdges(u) == out, at + ": getOutwardEdges");
+        check(sorted(c.getInwardEdges(u)) == sorted(g.getInwardEdges(u)), at + ": getInwardEdges");
+        check(c.outDegree(u) == g.outDegree(u) && c.inDegree(u) == g.inDegree(u), at + ": degrees");
+        for(int v : out)
+            check(c.connected(u, v) && c.weight(u, v) == g.weight(u, v), at + ": edge to " + to_string(v));
+    }
+    check(c.edgeCount() == edges, what + ": edgeCount");
+    for(int start = 0; start < n; start += 1 + n / 4)
+        check(c.BFS(start) == byId.BFS(start) && c.DFS(start) == byId.DFS(start), what + ": BFS/DFS from " + to_string(start));
+}
+
+int main()
+{
+    mt19937 rng(22);
+    for(int trial = 0; trial < 40; trial++)
+    {
+        int n = 1 + rng() % 300;
+        DGraphModel<int> g;
+        randomGraph(g, n, rng() % (6 * n + 1), rng, trial % 2 == 1);
+        // The same graph with every out-list in id order, the order the compressed lists keep
+        DGraphModel<int> byId;
+        vector<pair<int,int>> edges;
+        vector<float> weights;
+        for(int u = 0; u < n; u++) byId.add(u);
+        for(int u = 0; u < n; u++)
+        {
+            for(int v : sorted(g.getOutwardEdges(u)))
+            {
+                byId.connect(u, v, g.weight(u, v));
+                edges.push_back({u, v});
+                weights.push_back(g.weight(u, v));
+            }
+        }
+        string what = "trial " + to_string(trial);
+        CompressedGraph<int> plain = g.compress();
+        compare(plain, g, byId, what);
+        CompressedGraph<int> withIn = g.compress(true);
+        compare(withIn, g, byId, what + " with in-edges");
+        vector<int> values = g.vertices();
+        // Edge-list order should not matter
+        vector<size_t> order(edges.size());
+        for(size_t i = 0; i < order.size(); i++) order[i] = i;
+        shuffle(order.begin(), order.end(), rng);
+        vector<pair<int,int>> shuffled;
+        vector<float> shuffledWeights;
+        for(size_t i : order)
+        {
+            shuffled.push_back(edges[i]);
+            shuffledWeights.push_back(weights[i]);
+        }
+        CompressedGraph<int> direct(values, shuffled, &shuffledWeights, true);
+        compare(direct, g, byId, what + " from an edge list");
+    }
+    return finish("compressed_check");
+}
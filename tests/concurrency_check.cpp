@@ -0,0 +1,78 @@
+#include "check.h"
+#include <deque>
+
+// Checks for KnowledgeGraph::publish/reader: one writer grows a chain and
+// publishes after every relation while reader threads walk the versions they
+// pin, keeping a few views alive across publishes. One thread also holds more
+// views than a block of reader slots. Build with -fsanitize=thread or address
+// to catch a version reclaimed under a reader.
+
+static string entity(int i)
+{
+    return "e" + to_string(i);
+}
+
+// A version of the chain e0 -> e1 -> ... reaches every vertex from e0
+static void walk(ReadView<string> &view)
+{
+    if(view.versionNumber() == 0) return;
+    string order = view.BFS("e0");
+    int count = 1 + (int)std::count(order.begin(), order.end(), ' ');
+    check(count == view.size(), "bfs from e0 covers version " + to_string(view.versionNumber()));
+    check((int)view.related("e0", view.size()).size() == view.size() - 1, "related from e0");
+}
+
+int main()
+{
+    const int chain = 2000;
+    const int readers = 4;
+    KnowledgeGraph kg;
+    kg.addEntity(entity(0));
+
+    {
+        vector<ReadView<string>> views;
+        for(int i = 0; i < 200; i++)
+            views.push_back(kg.reader());
+        kg.publish();
+        views.push_back(kg.reader());
+        check(views.front().versionNumber() == 0 && views.back().versionNumber() == 1, "200 views pin at once");
+    }
+
+    atomic<bool> done(false);
+    vector<thread> threads;
+    for(int r = 0; r < readers; r++)
+    {
+        threads.emplace_back([&, r]() {
+            deque<ReadView<string>> held;
+            uint64_t last = 0;
+            while(!done.load())
+            {
+                held.push_back(kg.reader());
+                ReadView<string> &view = held.back();
+                check(view.versionNumber() >= last, "versions only move forward");
+                last = view.versionNumber();
+                walk(view);
+                // Keep up to r + 1 older views pinned while the writer publishes
+                if((int)held.size() > r + 1)
+                {
+                    walk(held.front());
+                    held.pop_front();
+                }
+            }
+        });
+    }
+
+    for(int i = 1; i < chain; i++)
+    {
+        kg.addEntity(entity(i));
+        kg.addRelation(entity(i - 1), entity(i));
+        kg.publish();
+    }
+    done.store(true);
+    for(auto &t : threads) t.join();
+
+    ReadView<string> view = kg.reader();
+    check(view.size() == chain, "last version holds the whole chain");
+    walk(view);
+    return finish("concurrency_check");
+}
@@ -0,0 +1,42 @@
+#include "check.h"
+
+// Checks for KnowledgeGraph::importEdgeList: files smaller than the worker
+// count, with and without a trailing newline, must import the same relations
+// whatever the thread count.
+
+static string importText(string text, int threads, ImportReport &report)
+{
+    string path = "import_check_" + to_string(getpid()) + ".tsv";
+    {
+        ofstream out(path, ios::binary);
+        out << text;
+    }
+    KnowledgeGraph kg;
+    report = kg.importEdgeList(path, '\t', threads);
+    unlink(path.c_str());
+    return kg.toString();
+}
+
+int main()
+{
+    vector<string> files = {"", "\n", "a\tb", "a\tb\n", "a\tb\nc\td\t2\n", "#c\na\tb\nb\tc"};
+    for(auto &text : files)
+    {
+        ImportReport expected;
+        string graph = importText(text, 1, expected);
+        for(int threads = 2; threads <= 8; threads++)
+        {
+            ImportReport report;
+            string name = "\"" + text + "\" with " + to_string(threads) + " threads";
+            check(importText(text, threads, report) == graph, name + ": graph");
+            check(report.lines == expected.lines, name + ": lines");
+            check(report.relations == expected.relations, name + ": relations");
+            check(report.entitiesAdded == expected.entitiesAdded, name + ": entities");
+            check(report.errors.size() == expected.errors.size(), name + ": errors");
+        }
+    }
+    ImportReport report;
+    importText("a\tb", 4, report);
+    check(report.relations == 1 && report.entitiesAdded == 2, "\"a\\tb\" with 4 threads imports one relation");
+    return finish("import_check");
+}
@@ -0,0 +1,19 @@
+#include "check.h"
+
+// Checks for DGraphModel error paths: calls naming a missing vertex must throw
+// VertexNotFoundException on a default-constructed graph (no vertex2str).
+
+int main()
+{
+    DGraphModel<int> g;
+    g.add(1);
+    check(throwsA<VertexNotFoundException>([&] { g.getOutwardEdges(5); }), "getOutwardEdges(5)");
+    check(throwsA<VertexNotFoundException>([&] { g.connect(1, 2); }), "connect(1, 2)");
+    check(throwsA<VertexNotFoundException>([&] { g.connect(2, 1); }), "connect(2, 1)");
+    check(throwsA<VertexNotFoundException>([&] { g.disconnect(1, 2); }), "disconnect(1, 2)");
+    check(throwsA<VertexNotFoundException>([&] { g.disconnect(2, 1); }), "disconnect(2, 1)");
+    check(throwsA<VertexNotFoundException>([&] { g.connected(1, 2); }), "connected(1, 2)");
+    check(throwsA<VertexNotFoundException>([&] { g.connected(2, 1); }), "connected(2, 1)");
+
+    return finish("model_check");
+}
@@ -0,0 +1,50 @@
+#include "check.h"
+
+// Checks for the bit-parallel DGraphModel::multiSourceBFS: the result for each
+// start must equal its serial BFSLevels within the same depth, less the start
+// itself, for batches that fill part of a word, whole words and more than one
+// 256-start pass (repeated starts included). KnowledgeGraph's
+// getRelatedEntitiesBatch must match getRelatedEntities(entity, depth, threads),
+// the overload with the same distance-then-insertion order, entity by entity.
+
+int main()
+{
+    mt19937 rng(10);
+    for(int trial = 0; trial < 40; trial++)
+    {
+        int n = 1 + rng() % 400;
+        int m = rng() % (4 * n + 1);
+        DGraphModel<int> g;
+        randomGraph(g, n, m, rng);
+        int counts[] = {1, 63, 64, 65, 256, 300};
+        int count = counts[trial % 6];
+        int depth = trial % 5 == 4 ? INT_MAX : trial % 5;
+        vector<int> starts;
+        for(int i = 0; i < count; i++) starts.push_back(rng() % n);
+        vector<vector<int>> result = g.multiSourceBFS(starts, depth);
+        check(result.size() == starts.size(), "trial " + to_string(trial) + ": one result per start");
+        for(size_t i = 0; i < starts.size() && i < result.size(); i++)
+        {
+            vector<int> expected;
+            vector<vector<int>> levels = g.BFSLevels(starts[i], 1, depth);
+            for(size_t d = 1; d < levels.size(); d++)
+                expected.insert(expected.end(), levels[d].begin(), levels[d].end());
+            check(result[i] == expected, "trial " + to_string(trial) + ": start " + to_string(i) + " (" + to_string(starts[i]) + ")");
+        }
+    }
+
+    KnowledgeGraph kg;
+    int n = 200;
+    for(int v = 0; v < n; v++) kg.addEntity("e" + to_string(v));
+    for(int i = 0; i < 500; i++) kg.addRelation("e" + to_string(rng() % n), "e" + to_string(rng() % n));
+    vector<string> entities;
+    for(int i = 0; i < 70; i++) entities.push_back("e" + to_string(rng() % n));
+    for(int depth : {0, 1, 3})
+    {
+        vector<vector<string>> batch = kg.getRelatedEntitiesBatch(entities, depth);
+        for(size_t i = 0; i < entities.size() && i < batch.size(); i++)
+            check(batch[i] == kg.getRelatedEntities(entities[i], depth, 1),
+                  "getRelatedEntitiesBatch(" + entities[i] + ", " + to_string(depth) + ")");
+    }
+    return finish("msbfs_check");
+}
@@ -0,0 +1,83 @@
+#include "check.h"
+
+// Checks for the weighted shortest-path queries: shortestDistances with one
+// thread (d-ary heap Dijkstra) and with four (delta-stepping) must both match
+// a plain O(V^2) Dijkstra on random graphs with integer weights, and every
+// shortestPath must follow real edges and add up to its distance. A negative
+// weight must throw only when it is reachable from the source, whatever the
+// thread count.
+
+static vector<float> referenceDistances(DGraphModel<int> &g, int source)
+{
+    const float INF = numeric_limits<float>::infinity();
+    int n = g.size();
+    vector<float> dist(n, INF);
+    vector<bool> done(n, false);
+    dist[source] = 0;
+    while(true)
+    {
+        int u = -1;
+        for(int v = 0; v < n; v++)
+        {
+            if(!done[v] && dist[v] < INF && (u < 0 || dist[v] < dist[u])) u = v;
+        }
+        if(u < 0) return dist;
+        done[u] = true;
+        for(int v : g.getOutwardEdges(u))
+            dist[v] = min(dist[v], dist[u] + g.weight(u, v));
+    }
+}
+
+static bool sameDistances(vector<pair<int,float>> found, vector<float> &expected)
+{
+    vector<float> dist(expected.size(), numeric_limits<float>::infinity());
+    for(auto &item : found) dist[item.first] = item.second;
+    return (int)found.size() == (int)count_if(expected.begin(), expected.end(), [](float d) { return !isinf(d); }) &&
+           dist == expected;
+}
+
+int main()
+{
+    mt19937 rng(12);
+    for(int trial = 0; trial < 50; trial++)
+    {
+        int n = 1 + rng() % 300;
+        DGraphModel<int> g;
+        randomGraph(g, n, rng() % (5 * n + 1), rng, true);
+        for(int i = 0; i < 4; i++)
+        {
+            int source = rng() % n;
+            string what = "trial " + to_string(trial) + " source " + to_string(source);
+            vector<float> expected = referenceDistances(g, source);
+            check(sameDistances(g.shortestDistances(source, 1), expected), what + ": 1 thread");
+            check(sameDistances(g.shortestDistances(source, 4), expected), what + ": 4 threads");
+            int target = rng() % n;
+            PathResult<int> path = g.shortestPath(source, target);
+            check(path.found == !isinf(expected[target]), what + ": path to " + to_string(target) + " found");
+            if(!path.found) continue;
+            float total = 0;
+            bool linked = path.path.front() == source && path.path.back() == target;
+            for(size_t k = 0; linked && k + 1 < path.path.size(); k++)
+            {
+                linked = g.connected(path.path[k], path.path[k + 1]);
+                if(linked) total += g.weight(path.path[k], path.path[k + 1]);
+            }
+            check(linked && total == expected[target] && path.distance == expected[target],
+                  what + ": path to " + to_string(target) + " adds up");
+        }
+    }
+
+    DGraphModel<int> weighted;
+    for(int i = 0; i < 4; i++) weighted.add(i);
+    weighted.connect(0, 1, 1);
+    weighted.connect(2, 3, -1);
+    for(int threads : {1, 4})
+    {
+        string what = "shortestDistances(0, " + to_string(threads) + ")";
+        try { check(weighted.shortestDistances(0, threads).size() == 2, what + ": two entries"); }
+        catch(NegativeWeightException &) { check(false, what + ": unreachable negative edge"); }
+        check(throwsA<NegativeWeightException>([&] { weighted.shortestDistances(2, threads); }),
+              "shortestDistances(2, " + to_string(threads) + "): reachable negative edge");
+    }
+    return finish("path_check");
+}
@@ -0,0 +1,61 @@
+#include "check.h"
+
+// Checks for the reachability index behind DGraphModel::reachable and
+// KnowledgeGraph::isReachable: every answer must match a plain BFS, on random
+// graphs with cycles, before and after edges are added or removed (which must
+// drop the index), and on the frozen CSR.
+
+static void compare(DGraphModel<int> &g, mt19937 &rng, string when)
+{
+    int n = g.size();
+    for(int i = 0; i < 3; i++)
+    {
+        int from = rng() % n;
+        vector<int> dist = hopDistances(g, from);
+        for(int to = 0; to < n; to++)
+            check(g.reachable(from, to) == (dist[to] >= 0), when + ": reachable(" + to_string(from) + ", " + to_string(to) + ")");
+    }
+}
+
+int main()
+{
+    mt19937 rng(9);
+    for(int trial = 0; trial < 60; trial++)
+    {
+        int n = trial % 10 == 9 ? 2000 : 1 + rng() % 200;
+        int m = rng() % (3 * n + 1);
+        DGraphModel<int> g;
+        randomGraph(g, n, m, rng);
+        string what = "trial " + to_string(trial);
+        compare(g, rng, what);
+        for(int i = 0; i < 5; i++) g.connect(rng() % n, rng() % n);
+        compare(g, rng, what + " after connect");
+        for(int u = 0; u < n; u++)
+        {
+            vector<int> targets = g.getOutwardEdges(u);
+            if(!targets.empty()) g.disconnect(u, targets[0]);
+        }
+        compare(g, rng, what + " after disconnect");
+        g.freeze();
+        compare(g, rng, what + " frozen");
+    }
+
+    KnowledgeGraph kg;
+    DGraphModel<int> model;
+    int n = 300;
+    randomGraph(model, n, 400, rng);
+    for(int v = 0; v < n; v++) kg.addEntity("e" + to_string(v));
+    for(int u = 0; u < n; u++)
+    {
+        for(int v : model.getOutwardEdges(u)) kg.addRelation("e" + to_string(u), "e" + to_string(v));
+    }
+    for(int i = 0; i < 20; i++)
+    {
+        int from = rng() % n;
+        vector<int> dist = hopDistances(model, from);
+        for(int to = 0; to < n; to++)
+            check(kg.isReachable("e" + to_string(from), "e" + to_string(to)) == (dist[to] >= 0),
+                  "isReachable(e" + to_string(from) + ", e" + to_string(to) + ")");
+    }
+    return finish("reach_check");
+}
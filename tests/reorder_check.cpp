@@ -0,0 +1,76 @@
+#include "check.h"
+
+// Checks for DGraphModel::reorder: with every layout, toString, the adjacency
+// lists in both directions, labels and BFS/DFS output must come out exactly
+// as before, and later edits must keep matching a graph that was never
+// reordered, through removal and compaction too.
+
+static string describe(DGraphModel<int> &g)
+{
+    stringstream out;
+    out << g.toString() << "\n";
+    for(int v : g.vertices())
+    {
+        out << v << ":";
+        for(int w : g.getOutwardEdges(v)) out << " " << w << "/" << g.label(v, w);
+        out << " |";
+        for(int w : g.getInwardEdges(v)) out << " " << w;
+        out << " | " << g.BFS(v) << " | " << g.DFS(v) << "\n";
+    }
+    return out.str();
+}
+
+int main()
+{
+    mt19937 rng(25);
+    VertexLayout layouts[] = {LAYOUT_BFS, LAYOUT_RCM, LAYOUT_DEGREE};
+    for(int trial = 0; trial < 30; trial++)
+    {
+        int n = 1 + rng() % 150;
+        int m = rng() % (4 * n + 1);
+        DGraphModel<int> g, plain;
+        for(int i = 0; i < n; i++)
+        {
+            g.add(i);
+            plain.add(i);
+        }
+        for(int i = 0; i < m; i++)
+        {
+            int u = rng() % n, v = rng() % n;
+            float w = rng() % 10;
+            uint32_t label = rng() % 3;
+            g.connect(u, v, w, label);
+            plain.connect(u, v, w, label);
+        }
+        VertexLayout layout = layouts[trial % 3];
+        string what = "trial " + to_string(trial) + " layout " + to_string(layout);
+        g.reorder(layout);
+        check(describe(g) == describe(plain), what + ": unchanged by reorder");
+
+        for(int i = 0; i < 20; i++)
+        {
+            int u = rng() % n, v = rng() % n;
+            if(i % 3 == 0)
+            {
+                g.disconnect(u, v);
+                plain.disconnect(u, v);
+            }
+            else
+            {
+                uint32_t label = rng() % 3;
+                g.connect(u, v, 1, label);
+                plain.connect(u, v, 1, label);
+            }
+        }
+        if(n > 1)
+        {
+            int victim = rng() % n;
+            g.remove(victim);
+            plain.remove(victim);
+            g.compact();
+            plain.compact();
+        }
+        check(describe(g) == describe(plain), what + ": edits after reorder");
+    }
+    return finish("reorder_check");
+}
@@ -0,0 +1,98 @@
+#include "check.h"
+
+// Checks for snapshot loading: a header whose sizes would wrap a bounds check,
+// a CSR target out of range (when contents are validated), and a file that
+// repeats a vertex value or entity name under a valid checksum must all be
+// rejected with SnapshotException.
+
+static string snapshotPath()
+{
+    return "snapshot_check_" + to_string(getpid()) + ".snap";
+}
+
+static string readFile(string path)
+{
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+// Writes the bytes back with the header checksum recomputed, as a forger would
+static void writeFile(string path, string bytes)
+{
+    SnapshotHeader header;
+    memcpy(&header, bytes.data(), sizeof(header));
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = sizeof(header); i < bytes.size(); i++)
+    {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    header.checksum = hash;
+    memcpy(&bytes[0], &header, sizeof(header));
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(bytes.data(), bytes.size());
+}
+
+int main()
+{
+    string path = snapshotPath();
+
+    DGraphModel<int> chain;
+    for(int i = 0; i < 8; i++) chain.add(i);
+    for(int i = 0; i + 1 < 8; i++) chain.connect(i, i + 1, 1);
+    chain.save(path);
+    string bytes = readFile(path);
+    SnapshotHeader header;
+    memcpy(&header, bytes.data(), sizeof(header));
+    header.hashSlots = 1ULL << 62;
+    header.section[SNAP_HASH] = header.fileSize;
+    memcpy(&bytes[0], &header, sizeof(header));
+    writeFile(path, bytes);
+    check(throwsA<SnapshotException>([&] { GraphSnapshot<int> snapshot(path); }), "snapshot with hashSlots = 2^62");
+
+    // An edge target past the last vertex: open trusts it, validate() does not
+    chain.save(path);
+    bytes = readFile(path);
+    memcpy(&header, bytes.data(), sizeof(header));
+    int outside = 999;
+    memcpy(&bytes[header.section[SNAP_TARGETS]], &outside, sizeof(int));
+    writeFile(path, bytes);
+    {
+        GraphSnapshot<int> trusted(path);
+        check(!trusted.validate(), "validate() rejects an edge target out of range");
+    }
+    check(throwsA<SnapshotException>([&] { GraphSnapshot<int> snapshot(path, nullptr, false, true); }),
+          "validateContents rejects an edge target out of range");
+
+    // Vertex 1 rewritten to 0
+    chain.save(path);
+    bytes = readFile(path);
+    memcpy(&header, bytes.data(), sizeof(header));
+    int zero = 0;
+    memcpy(&bytes[header.section[SNAP_VALUES] + sizeof(int)], &zero, sizeof(int));
+    writeFile(path, bytes);
+    DGraphModel<int> loaded;
+    check(throwsA<SnapshotException>([&] { loaded.load(path); }), "DGraphModel snapshot repeating a vertex");
+    check(loaded.size() == 0, "DGraphModel left empty after a rejected load");
+
+    // Entity "ab" rewritten to "aa"
+    KnowledgeGraph kg;
+    kg.addEntity("aa");
+    kg.addEntity("ab");
+    kg.addEntity("zz");
+    kg.addRelation("aa", "zz");
+    kg.save(path);
+    bytes = readFile(path);
+    size_t at = bytes.find("aaab");
+    check(at != string::npos, "entity names stored back to back");
+    if(at != string::npos)
+    {
+        bytes[at + 3] = 'a';
+        writeFile(path, bytes);
+        KnowledgeGraph repeated;
+        check(throwsA<SnapshotException>([&] { repeated.load(path); }), "KnowledgeGraph snapshot repeating a name");
+    }
+
+    unlink(path.c_str());
+    return finish("snapshot_check");
+}